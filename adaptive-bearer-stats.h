@@ -0,0 +1,508 @@
+#ifndef ADAPTIVE_BEARER_STATS_H
+#define ADAPTIVE_BEARER_STATS_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * RLC or PDCP statistics calculator with one adaptive epoch per bearer.
+ *
+ * RadioBearerStatsCalculator closes the epoch of every bearer together, every
+ * EpochDuration, and writes a row per bearer each time. Here each bearer (IMSI,
+ * LCID and direction) has its own epoch, which starts at MinEpoch and doubles,
+ * up to MaxEpoch, each time its throughput and mean delay stay within
+ * Tolerance of the previous epoch. It falls back to MinEpoch when they change,
+ * when the bearer is set up again (attach, handover) and, without waiting for
+ * the end of a long epoch, when the throughput or delay measured over the
+ * last MinEpoch moves by more than FlushThreshold from the previous epoch
+ * (e.g. traffic starting or stopping): the epoch is then flushed at once.
+ * The windows are checked on the PDU received once they are MinEpoch long,
+ * and every MinEpoch by a single event for all the bearers, which catches
+ * the windows without PDUs of a bearer whose traffic stopped.
+ *
+ * Steady bearers so cost one row and one event per MaxEpoch, plus their
+ * share of the scan every MinEpoch, while transients keep MinEpoch detail.
+ * Only the epochs that carried PDUs are written, in the
+ * RadioBearerStatsCalculator format (delays in seconds), so the files read
+ * like DlRlcStats.txt with rows of varying length.
+ */
+class AdaptiveBearerStatsCalculator : public Object
+{
+  public:
+    AdaptiveBearerStatsCalculator()
+    {
+    }
+
+    ~AdaptiveBearerStatsCalculator() override
+    {
+    }
+
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::AdaptiveBearerStatsCalculator")
+                .SetParent<Object>()
+                .AddConstructor<AdaptiveBearerStatsCalculator>()
+                .AddAttribute("Layer",
+                              "Layer whose PDUs are counted: LteRlc or LtePdcp",
+                              StringValue("LteRlc"),
+                              MakeStringAccessor(&AdaptiveBearerStatsCalculator::m_layer),
+                              MakeStringChecker())
+                .AddAttribute("DlOutputFilename",
+                              "Name of the file where the downlink results will be saved",
+                              StringValue("DlRlcStats.txt"),
+                              MakeStringAccessor(&AdaptiveBearerStatsCalculator::m_dlFileName),
+                              MakeStringChecker())
+                .AddAttribute("UlOutputFilename",
+                              "Name of the file where the uplink results will be saved",
+                              StringValue("UlRlcStats.txt"),
+                              MakeStringAccessor(&AdaptiveBearerStatsCalculator::m_ulFileName),
+                              MakeStringChecker())
+                .AddAttribute("MinEpoch",
+                              "Epoch of a bearer in a transient",
+                              TimeValue(MilliSeconds(50)),
+                              MakeTimeAccessor(&AdaptiveBearerStatsCalculator::m_minEpoch),
+                              MakeTimeChecker(TimeStep(1)))
+                .AddAttribute("MaxEpoch",
+                              "Longest epoch of a steady bearer",
+                              TimeValue(MilliSeconds(1600)),
+                              MakeTimeAccessor(&AdaptiveBearerStatsCalculator::m_maxEpoch),
+                              MakeTimeChecker(TimeStep(1)))
+                .AddAttribute("Tolerance",
+                              "Relative change of the throughput and mean delay between "
+                              "two epochs below which a bearer is steady",
+                              DoubleValue(0.1),
+                              MakeDoubleAccessor(&AdaptiveBearerStatsCalculator::m_tolerance),
+                              MakeDoubleChecker<double>(0))
+                .AddAttribute("FlushThreshold",
+                              "Relative change over the last MinEpoch that ends the "
+                              "current epoch at once",
+                              DoubleValue(0.5),
+                              MakeDoubleAccessor(&AdaptiveBearerStatsCalculator::m_flushThreshold),
+                              MakeDoubleChecker<double>(0));
+        return tid;
+    }
+
+    /**
+     * Open the output files and follow the data radio bearers set up from
+     * now on, at every eNB and UE. To be called before the UEs attach.
+     */
+    void Install()
+    {
+        NS_ABORT_MSG_IF(m_layer != "LteRlc" && m_layer != "LtePdcp",
+                        "Unknown layer " << m_layer);
+        NS_ABORT_MSG_IF(m_maxEpoch < m_minEpoch, "MaxEpoch is shorter than MinEpoch");
+        for (auto* file : {&m_dlFile, &m_ulFile})
+        {
+            file->open(file == &m_dlFile ? m_dlFileName : m_ulFileName);
+            NS_ABORT_MSG_IF(!file->is_open(), "Cannot write the " << m_layer << " statistics");
+            *file << "% start\tend\tCellId\tIMSI\tRNTI\tLCID\tnTxPDUs\tTxBytes\tnRxPDUs\t"
+                     "RxBytes\tdelay\tstdDev\tmin\tmax\tPduSize\tstdDev\tmin\tmax"
+                  << std::endl;
+        }
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/DrbCreated",
+                        MakeBoundCallback(&AdaptiveBearerStatsCalculator::EnbDrbCreated, this));
+        Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/DrbCreated",
+                        MakeBoundCallback(&AdaptiveBearerStatsCalculator::UeDrbCreated, this));
+        Simulator::Schedule(m_minEpoch, &AdaptiveBearerStatsCalculator::CheckWindows, this);
+    }
+
+    /// Write the epochs in progress, e.g. at the end of the simulation
+    void Flush()
+    {
+        for (auto& kv : m_bearers)
+        {
+            if (kv.second.start < Simulator::Now())
+            {
+                kv.second.endEvent.Cancel();
+                WriteEpoch(kv.first, kv.second, Simulator::Now());
+            }
+        }
+        m_dlFile.flush();
+        m_ulFile.flush();
+    }
+
+  protected:
+    void DoDispose() override
+    {
+        for (auto& kv : m_bearers)
+        {
+            kv.second.endEvent.Cancel();
+        }
+        m_bearers.clear();
+        Object::DoDispose();
+    }
+
+  private:
+    /// Direction of a bearer
+    enum Direction : uint8_t
+    {
+        DL = 0,
+        UL = 1,
+    };
+
+    /// Count, sum, sum of squares, minimum and maximum of samples
+    struct Moments
+    {
+        uint64_t n = 0;                                  //!< Number of samples
+        double sum = 0;                                  //!< Sum
+        double sumSq = 0;                                //!< Sum of squares
+        double min = std::numeric_limits<double>::max(); //!< Minimum
+        double max = 0;                                  //!< Maximum
+
+        /**
+         * \param x A sample.
+         */
+        void Add(double x)
+        {
+            n++;
+            sum += x;
+            sumSq += x * x;
+            min = std::min(min, x);
+            max = std::max(max, x);
+        }
+
+        /// \return The mean.
+        double Mean() const
+        {
+            return n > 0 ? sum / n : 0;
+        }
+
+        /// \return The standard deviation.
+        double StdDev() const
+        {
+            return n > 1 ? std::sqrt(std::max(0.0, (sumSq - sum * sum / n) / (n - 1))) : 0;
+        }
+    };
+
+    /// State of one bearer
+    struct Bearer
+    {
+        uint16_t cellId = 0;      //!< Serving cell
+        uint16_t rnti = 0;        //!< RNTI in the serving cell
+        Time start;               //!< Start of the current epoch
+        Time epoch;               //!< Length of the current epoch
+        EventId endEvent;         //!< End of the current epoch
+        uint64_t txPdus = 0;      //!< PDUs sent in the epoch
+        uint64_t txBytes = 0;     //!< Bytes sent in the epoch
+        Moments delay;            //!< Delays of the PDUs received in the epoch, in s
+        Moments size;             //!< Sizes of the PDUs received in the epoch
+        double lastRate = 0;      //!< Throughput of the previous epoch, in B/s
+        double lastDelay = 0;     //!< Mean delay of the previous epoch, in s
+        Time windowStart;         //!< Start of the flush detection window
+        uint64_t windowBytes = 0; //!< Bytes received in the window
+        double windowDelay = 0;   //!< Sum of the delays received in the window
+        uint64_t windowPdus = 0;  //!< PDUs received in the window
+    };
+
+    /**
+     * \param dir The direction.
+     * \param imsi The IMSI.
+     * \param lcid The logical channel.
+     * \return The key of the bearer.
+     */
+    static uint64_t Key(Direction dir, uint64_t imsi, uint8_t lcid)
+    {
+        return (imsi << 9) | (static_cast<uint64_t>(lcid) << 1) | dir;
+    }
+
+    /**
+     * \param context The trace context, /NodeList/n/DeviceList/d/Lte*Rrc/DrbCreated.
+     * \return The path of the RRC, with its trailing '/'.
+     */
+    static std::string RrcPath(const std::string& context)
+    {
+        return context.substr(0, context.rfind('/') + 1);
+    }
+
+    /**
+     * A DRB was set up at an eNB: follow its DL transmissions and UL receptions.
+     *
+     * \param calc The calculator.
+     * \param context The trace context.
+     * \param imsi The IMSI.
+     * \param cellId The cell.
+     * \param rnti The RNTI.
+     * \param lcid The logical channel.
+     */
+    static void EnbDrbCreated(AdaptiveBearerStatsCalculator* calc,
+                              std::string context,
+                              uint64_t imsi,
+                              uint16_t cellId,
+                              uint16_t rnti,
+                              uint8_t lcid)
+    {
+        // DRB ids are the LCIDs minus the two SRBs
+        std::ostringstream path;
+        path << RrcPath(context) << "UeMap/" << rnti << "/DataRadioBearerMap/" << lcid - 2 << "/"
+             << calc->m_layer << "/";
+        Config::ConnectWithoutContext(
+            path.str() + "TxPDU",
+            MakeBoundCallback(&AdaptiveBearerStatsCalculator::TxPdu, calc, DL, imsi));
+        Config::ConnectWithoutContext(
+            path.str() + "RxPDU",
+            MakeBoundCallback(&AdaptiveBearerStatsCalculator::RxPdu, calc, UL, imsi));
+        calc->Setup(Key(DL, imsi, lcid), cellId, rnti);
+        calc->Setup(Key(UL, imsi, lcid), cellId, rnti);
+    }
+
+    /**
+     * A DRB was set up at a UE: follow its DL receptions and UL transmissions.
+     *
+     * \param calc The calculator.
+     * \param context The trace context.
+     * \param imsi The IMSI.
+     * \param cellId The cell.
+     * \param rnti The RNTI.
+     * \param lcid The logical channel.
+     */
+    static void UeDrbCreated(AdaptiveBearerStatsCalculator* calc,
+                             std::string context,
+                             uint64_t imsi,
+                             uint16_t cellId,
+                             uint16_t rnti,
+                             uint8_t lcid)
+    {
+        std::ostringstream path;
+        path << RrcPath(context) << "DataRadioBearerMap/" << lcid - 2 << "/" << calc->m_layer
+             << "/";
+        Config::ConnectWithoutContext(
+            path.str() + "RxPDU",
+            MakeBoundCallback(&AdaptiveBearerStatsCalculator::RxPdu, calc, DL, imsi));
+        Config::ConnectWithoutContext(
+            path.str() + "TxPDU",
+            MakeBoundCallback(&AdaptiveBearerStatsCalculator::TxPdu, calc, UL, imsi));
+    }
+
+    /**
+     * Start a fine epoch for a new bearer, or for one set up again in a cell.
+     *
+     * \param key The bearer.
+     * \param cellId The cell.
+     * \param rnti The RNTI.
+     */
+    void Setup(uint64_t key, uint16_t cellId, uint16_t rnti)
+    {
+        auto it = m_bearers.find(key);
+        if (it != m_bearers.end())
+        {
+            it->second.endEvent.Cancel();
+            WriteEpoch(key, it->second, Simulator::Now());
+        }
+        Bearer& bearer = m_bearers[key];
+        bearer.cellId = cellId;
+        bearer.rnti = rnti;
+        StartEpoch(key, bearer, m_minEpoch);
+    }
+
+    /**
+     * \param calc The calculator.
+     * \param dir The direction.
+     * \param imsi The IMSI.
+     * \param rnti The RNTI.
+     * \param lcid The logical channel.
+     * \param size The PDU size.
+     */
+    static void TxPdu(AdaptiveBearerStatsCalculator* calc,
+                      Direction dir,
+                      uint64_t imsi,
+                      uint16_t rnti,
+                      uint8_t lcid,
+                      uint32_t size)
+    {
+        auto it = calc->m_bearers.find(Key(dir, imsi, lcid));
+        if (it != calc->m_bearers.end())
+        {
+            it->second.txPdus++;
+            it->second.txBytes += size;
+        }
+    }
+
+    /**
+     * \param calc The calculator.
+     * \param dir The direction.
+     * \param imsi The IMSI.
+     * \param rnti The RNTI.
+     * \param lcid The logical channel.
+     * \param size The PDU size.
+     * \param delay The PDU delay, in ns.
+     */
+    static void RxPdu(AdaptiveBearerStatsCalculator* calc,
+                      Direction dir,
+                      uint64_t imsi,
+                      uint16_t rnti,
+                      uint8_t lcid,
+                      uint32_t size,
+                      uint64_t delay)
+    {
+        uint64_t key = Key(dir, imsi, lcid);
+        auto it = calc->m_bearers.find(key);
+        if (it == calc->m_bearers.end())
+        {
+            return;
+        }
+        Bearer& bearer = it->second;
+        bearer.delay.Add(delay * 1e-9);
+        bearer.size.Add(size);
+        bearer.windowBytes += size;
+        bearer.windowDelay += delay * 1e-9;
+        bearer.windowPdus++;
+        if (bearer.epoch > calc->m_minEpoch &&
+            Simulator::Now() - bearer.windowStart >= calc->m_minEpoch)
+        {
+            calc->CheckWindow(key, bearer);
+        }
+    }
+
+    /// Check the windows no PDU closed, and schedule the next check.
+    void CheckWindows()
+    {
+        for (auto& kv : m_bearers)
+        {
+            Bearer& bearer = kv.second;
+            if (bearer.epoch > m_minEpoch && Simulator::Now() - bearer.windowStart >= m_minEpoch)
+            {
+                CheckWindow(kv.first, bearer);
+            }
+        }
+        Simulator::Schedule(m_minEpoch, &AdaptiveBearerStatsCalculator::CheckWindows, this);
+    }
+
+    /**
+     * Flush a coarse epoch if the last window moved away from the previous
+     * epoch, else start a new window. A window without PDUs has no delay.
+     *
+     * \param key The bearer.
+     * \param bearer Its state.
+     */
+    void CheckWindow(uint64_t key, Bearer& bearer)
+    {
+        double rate = bearer.windowBytes / (Simulator::Now() - bearer.windowStart).GetSeconds();
+        bool changed = Changed(rate, bearer.lastRate, m_flushThreshold);
+        if (bearer.windowPdus > 0)
+        {
+            double delay = bearer.windowDelay / bearer.windowPdus;
+            changed = changed || Changed(delay, bearer.lastDelay, m_flushThreshold);
+        }
+        if (changed)
+        {
+            bearer.endEvent.Cancel();
+            WriteEpoch(key, bearer, Simulator::Now());
+            StartEpoch(key, bearer, m_minEpoch);
+            return;
+        }
+        bearer.windowStart = Simulator::Now();
+        bearer.windowBytes = 0;
+        bearer.windowDelay = 0;
+        bearer.windowPdus = 0;
+    }
+
+    /**
+     * End of the epoch of a bearer: write it and pick the next epoch length.
+     * \param key The bearer.
+     */
+    void EndEpoch(uint64_t key)
+    {
+        Bearer& bearer = m_bearers.at(key);
+        double lastRate = bearer.lastRate;
+        double lastDelay = bearer.lastDelay;
+        WriteEpoch(key, bearer, Simulator::Now());
+        bool steady = !Changed(bearer.lastRate, lastRate, m_tolerance) &&
+                      !Changed(bearer.lastDelay, lastDelay, m_tolerance);
+        StartEpoch(key, bearer, steady ? std::min(bearer.epoch * 2, m_maxEpoch) : m_minEpoch);
+    }
+
+    /**
+     * \param key The bearer.
+     * \param bearer Its state.
+     * \param epoch Length of the new epoch.
+     */
+    void StartEpoch(uint64_t key, Bearer& bearer, Time epoch)
+    {
+        bearer.start = Simulator::Now();
+        bearer.epoch = epoch;
+        bearer.windowStart = bearer.start;
+        bearer.endEvent =
+            Simulator::Schedule(epoch, &AdaptiveBearerStatsCalculator::EndEpoch, this, key);
+    }
+
+    /**
+     * Write the epoch of a bearer if it carried PDUs, then reset its counters.
+     * The throughput and mean delay of the epoch become the reference of the
+     * next one.
+     *
+     * \param key The bearer.
+     * \param bearer Its state.
+     * \param end End of the epoch.
+     */
+    void WriteEpoch(uint64_t key, Bearer& bearer, Time end)
+    {
+        double length = (end - bearer.start).GetSeconds();
+        bearer.lastRate = length > 0 ? bearer.size.sum / length : 0;
+        bearer.lastDelay = bearer.delay.Mean();
+        if (bearer.txPdus > 0 || bearer.delay.n > 0)
+        {
+            std::ofstream& file = (key & 1) == DL ? m_dlFile : m_ulFile;
+            file << bearer.start.GetSeconds() << "\t" << end.GetSeconds() << "\t"
+                 << bearer.cellId << "\t" << (key >> 9) << "\t" << bearer.rnti << "\t"
+                 << ((key >> 1) & 0xff) << "\t" << bearer.txPdus << "\t" << bearer.txBytes
+                 << "\t" << bearer.delay.n << "\t" << bearer.size.sum << "\t"
+                 << bearer.delay.Mean() << "\t" << bearer.delay.StdDev() << "\t"
+                 << (bearer.delay.n > 0 ? bearer.delay.min : 0) << "\t" << bearer.delay.max
+                 << "\t" << bearer.size.Mean() << "\t" << bearer.size.StdDev() << "\t"
+                 << (bearer.size.n > 0 ? bearer.size.min : 0) << "\t" << bearer.size.max
+                 << "\n";
+        }
+        bearer.txPdus = 0;
+        bearer.txBytes = 0;
+        bearer.delay = Moments();
+        bearer.size = Moments();
+        bearer.windowBytes = 0;
+        bearer.windowDelay = 0;
+        bearer.windowPdus = 0;
+    }
+
+    /**
+     * \param value A new value.
+     * \param reference The reference value.
+     * \param threshold Relative threshold.
+     * \return Whether value differs from reference by more than threshold.
+     */
+    static bool Changed(double value, double reference, double threshold)
+    {
+        if (reference == 0)
+        {
+            return value != 0;
+        }
+        return std::fabs(value - reference) > threshold * std::fabs(reference);
+    }
+
+    std::string m_layer;                            //!< LteRlc or LtePdcp
+    std::string m_dlFileName;                       //!< DL output file name
+    std::string m_ulFileName;                       //!< UL output file name
+    Time m_minEpoch;                                //!< Epoch in transients
+    Time m_maxEpoch;                                //!< Longest epoch
+    double m_tolerance;                             //!< Steady state tolerance
+    double m_flushThreshold;                        //!< Early flush threshold
+    std::ofstream m_dlFile;                         //!< DL output
+    std::ofstream m_ulFile;                         //!< UL output
+    std::unordered_map<uint64_t, Bearer> m_bearers; //!< Bearers by key
+};
+
+NS_OBJECT_ENSURE_REGISTERED(AdaptiveBearerStatsCalculator);
+
+} // namespace ns3
+
+#endif // ADAPTIVE_BEARER_STATS_H
@@ -0,0 +1,221 @@
+#ifndef BATCHED_BEARER_ACTIVATOR_H
+#define BATCHED_BEARER_ACTIVATOR_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+
+#include <functional>
+
+namespace ns3
+{
+
+/**
+ * Attaches large numbers of UEs and activates their dedicated EPS bearers in
+ * one pass, spreading the signalling over an attach window.
+ *
+ * Bearers queued in the UE NAS before the connection is set up travel in the
+ * initial context setup of the attach: the MME, SGW and eNB handle all the
+ * bearers of a UE in one request and the UE gets a single RRC connection
+ * reconfiguration. This helper does the activation right after scheduling
+ * each UE's attach, so that every UE follows that path, and attaches the UEs
+ * in batches spread over time instead of all of them at t=0.
+ */
+class BatchedBearerActivator
+{
+  public:
+    /**
+     * Builds the TFT of one dedicated bearer.
+     *
+     * \param ueIndex Index of the UE in the device container.
+     * \param bearerIndex Index of the bearer of this UE.
+     * \return The TFT of the bearer.
+     */
+    typedef std::function<Ptr<EpcTft>(uint32_t ueIndex, uint32_t bearerIndex)> TftFactory;
+
+    /**
+     * \param lteHelper The LTE helper, with an EPC helper set.
+     */
+    BatchedBearerActivator(Ptr<LteHelper> lteHelper)
+        : m_lteHelper(lteHelper),
+          m_attachWindow(Seconds(0)),
+          m_batchSize(100),
+          m_bearersPerUe(0),
+          m_bearer(EpsBearer::NGBR_VIDEO_TCP_DEFAULT)
+    {
+    }
+
+    /**
+     * \param window Duration over which the attach batches are spread.
+     * \param batchSize Number of UEs attached together.
+     */
+    void SetAttachSpread(Time window, uint32_t batchSize)
+    {
+        NS_ABORT_MSG_IF(batchSize == 0, "The attach batch size must be positive");
+        m_attachWindow = window;
+        m_batchSize = batchSize;
+    }
+
+    /**
+     * Set the dedicated bearers activated on every UE.
+     *
+     * \param bearer The bearer QoS.
+     * \param bearersPerUe Number of dedicated bearers per UE, 0 for none.
+     * \param tftFactory Builds the TFT of each bearer.
+     */
+    void SetDedicatedBearers(EpsBearer bearer, uint32_t bearersPerUe, TftFactory tftFactory)
+    {
+        m_bearer = bearer;
+        m_bearersPerUe = bearersPerUe;
+        m_tftFactory = tftFactory;
+    }
+
+    /**
+     * Schedule the attach of every UE to its closest eNB and the activation
+     * of its dedicated bearers.
+     *
+     * \param ueDevices The UE devices.
+     * \param enbDevices The candidate eNB devices.
+     */
+    void AttachToClosestEnb(NetDeviceContainer ueDevices, NetDeviceContainer enbDevices)
+    {
+        Ptr<LteHelper> lteHelper = m_lteHelper;
+        ScheduleBatches(ueDevices,
+                        [lteHelper, ueDevices, enbDevices](uint32_t first, uint32_t last) {
+                            NetDeviceContainer batch;
+                            for (uint32_t i = first; i < last; i++)
+                            {
+                                batch.Add(ueDevices.Get(i));
+                            }
+                            lteHelper->AttachToClosestEnb(batch, enbDevices);
+                        });
+    }
+
+    /**
+     * Schedule the attach of every UE to a given eNB and the activation of
+     * its dedicated bearers.
+     *
+     * \param ueDevices The UE devices.
+     * \param enbDevices The eNB devices.
+     * \param enbIndexOf Index in enbDevices of the eNB of a UE.
+     */
+    void AttachToEnb(NetDeviceContainer ueDevices,
+                     NetDeviceContainer enbDevices,
+                     std::function<uint32_t(uint32_t ueIndex)> enbIndexOf)
+    {
+        Ptr<LteHelper> lteHelper = m_lteHelper;
+        ScheduleBatches(ueDevices,
+                        [lteHelper, ueDevices, enbDevices, enbIndexOf](uint32_t first,
+                                                                       uint32_t last) {
+                            for (uint32_t i = first; i < last; i++)
+                            {
+                                lteHelper->Attach(ueDevices.Get(i),
+                                                  enbDevices.Get(enbIndexOf(i)));
+                            }
+                        });
+    }
+
+    /**
+     * Schedule the idle mode attach of every UE, which selects its cell from
+     * the received signals, and the activation of its dedicated bearers.
+     *
+     * \param ueDevices The UE devices.
+     */
+    void Attach(NetDeviceContainer ueDevices)
+    {
+        Ptr<LteHelper> lteHelper = m_lteHelper;
+        ScheduleBatches(ueDevices, [lteHelper, ueDevices](uint32_t first, uint32_t last) {
+            for (uint32_t i = first; i < last; i++)
+            {
+                lteHelper->Attach(ueDevices.Get(i));
+            }
+        });
+    }
+
+    /**
+     * \param ueIndex Index of the UE in the device container.
+     * \return The time at which the UE attaches.
+     */
+    Time GetAttachTime(uint32_t ueIndex) const
+    {
+        return m_attachTimes.at(ueIndex);
+    }
+
+  private:
+    /// Attaches the UEs with index in [first, last)
+    typedef std::function<void(uint32_t first, uint32_t last)> BatchAttach;
+
+    /**
+     * Spread the batches over the attach window.
+     *
+     * \param ueDevices The UE devices.
+     * \param attach Attaches one batch.
+     */
+    void ScheduleBatches(NetDeviceContainer ueDevices, BatchAttach attach)
+    {
+        NS_ABORT_MSG_IF(m_bearersPerUe > 0 && !m_tftFactory, "No TFT factory set");
+        uint32_t numBatches = (ueDevices.GetN() + m_batchSize - 1) / m_batchSize;
+        m_attachTimes.resize(ueDevices.GetN());
+        for (uint32_t batch = 0; batch < numBatches; batch++)
+        {
+            uint32_t first = batch * m_batchSize;
+            uint32_t last = std::min(first + m_batchSize, ueDevices.GetN());
+            Time at = numBatches > 1 ? m_attachWindow * batch / numBatches : Seconds(0);
+            for (uint32_t i = first; i < last; i++)
+            {
+                m_attachTimes[i] = at;
+            }
+            if (at.IsZero())
+            {
+                AttachBatch(ueDevices, attach, first, last);
+            }
+            else
+            {
+                Simulator::Schedule(at,
+                                    &BatchedBearerActivator::AttachBatch,
+                                    this,
+                                    ueDevices,
+                                    attach,
+                                    first,
+                                    last);
+            }
+        }
+    }
+
+    /**
+     * Attach one batch of UEs and queue their dedicated bearers in the NAS.
+     *
+     * \param ueDevices All UE devices.
+     * \param attach Attaches the batch.
+     * \param first Index of the first UE of the batch.
+     * \param last Index past the last UE of the batch.
+     */
+    void AttachBatch(NetDeviceContainer ueDevices,
+                     BatchAttach attach,
+                     uint32_t first,
+                     uint32_t last)
+    {
+        attach(first, last);
+
+        for (uint32_t i = first; i < last; i++)
+        {
+            for (uint32_t b = 0; b < m_bearersPerUe; b++)
+            {
+                m_lteHelper->ActivateDedicatedEpsBearer(ueDevices.Get(i),
+                                                        m_bearer,
+                                                        m_tftFactory(i, b));
+            }
+        }
+    }
+
+    Ptr<LteHelper> m_lteHelper;      //!< LTE helper
+    Time m_attachWindow;             //!< Window over which attaches are spread
+    uint32_t m_batchSize;            //!< UEs attached together
+    uint32_t m_bearersPerUe;         //!< Dedicated bearers per UE
+    EpsBearer m_bearer;              //!< Dedicated bearer QoS
+    TftFactory m_tftFactory;         //!< TFT of each dedicated bearer
+    std::vector<Time> m_attachTimes; //!< Attach time of each UE
+};
+
+} // namespace ns3
+
+#endif // BATCHED_BEARER_ACTIVATOR_H
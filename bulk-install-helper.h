@@ -0,0 +1,234 @@
+#ifndef BULK_INSTALL_HELPER_H
+#define BULK_INSTALL_HELPER_H
+
+#include <ns3/core-module.h>
+#include <ns3/internet-module.h>
+#include <ns3/lte-module.h>
+#include <ns3/point-to-point-epc-helper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+
+namespace ns3
+{
+
+/**
+ * Wall clock time spent in each setup phase of a scenario.
+ *
+ * Phases are identified by name and may be entered several times (once per
+ * batch); their durations add up. The report shows each phase as a share of
+ * the whole process, including Simulator::Run() when it is timed as a phase.
+ */
+class SetupPhaseTimer
+{
+  public:
+    /**
+     * Start timing a phase, stopping the current one if any.
+     * \param phase The phase name.
+     */
+    void Start(const std::string& phase)
+    {
+        Stop();
+        m_current = phase;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    /// Stop timing the current phase
+    void Stop()
+    {
+        if (m_current.empty())
+        {
+            return;
+        }
+        double elapsed =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        auto it = std::find_if(m_phases.begin(), m_phases.end(), [this](const Phase& p) {
+            return p.first == m_current;
+        });
+        if (it == m_phases.end())
+        {
+            m_phases.emplace_back(m_current, elapsed);
+        }
+        else
+        {
+            it->second += elapsed;
+        }
+        m_current.clear();
+    }
+
+    /**
+     * Print the time spent in each phase.
+     * \param os The output stream.
+     */
+    void Print(std::ostream& os)
+    {
+        Stop();
+        double total = 0;
+        for (const auto& p : m_phases)
+        {
+            total += p.second;
+        }
+        os << std::left << std::setw(24) << "phase" << std::right << std::setw(12) << "wall [s]"
+           << std::setw(10) << "share" << std::endl;
+        for (const auto& p : m_phases)
+        {
+            os << std::left << std::setw(24) << p.first << std::right << std::setw(12)
+               << std::fixed << std::setprecision(3) << p.second << std::setw(9)
+               << std::setprecision(1) << (total > 0 ? 100 * p.second / total : 0) << "%"
+               << std::endl;
+        }
+        os << std::left << std::setw(24) << "total" << std::right << std::setw(12)
+           << std::setprecision(3) << total << std::endl;
+        os.unsetf(std::ios::fixed);
+    }
+
+  private:
+    /// Phase name and accumulated duration in seconds
+    typedef std::pair<std::string, double> Phase;
+
+    std::vector<Phase> m_phases;                   //!< Phases in first-start order
+    std::string m_current;                         //!< Running phase, empty if none
+    std::chrono::steady_clock::time_point m_start; //!< Start of the running phase
+};
+
+/**
+ * Installs the LTE device, an IPv4-only internet stack, the EPC address and
+ * the default route of large numbers of UEs, one batch at a time.
+ *
+ * The UEs only get the IPv4 stack the EPC uses: the IPv6 stack that
+ * InternetStackHelper installs by default is never used by our scenarios.
+ * That is the only work saved over the stock helpers. A batch goes through
+ * all layers before the next batch starts, but each node still gets one
+ * Install call per layer: nothing is preallocated, shared or deferred, and
+ * the batch size does not change the work done.
+ */
+class LteBulkUeInstaller
+{
+  public:
+    /**
+     * Runs one install step for one node. The default just runs the step;
+     * scenarios can wrap it, e.g. in a memory accounting scope.
+     */
+    typedef std::function<
+        void(Ptr<Node> node, const std::string& layer, std::function<void()> step)>
+        NodeWrapper;
+
+    /**
+     * \param lteHelper The LTE helper, with its EPC helper already set.
+     * \param epcHelper The EPC helper.
+     * \param batchSize Number of UEs installed per batch, at least one.
+     */
+    LteBulkUeInstaller(Ptr<LteHelper> lteHelper,
+                       Ptr<PointToPointEpcHelper> epcHelper,
+                       uint32_t batchSize)
+        : m_lteHelper(lteHelper),
+          m_epcHelper(epcHelper),
+          m_batchSize(batchSize),
+          m_timer(nullptr),
+          m_wrapper([](Ptr<Node>, const std::string&, std::function<void()> step) { step(); })
+    {
+        NS_ABORT_MSG_IF(batchSize == 0, "The UE install batches need at least one UE");
+        m_internet.SetIpv6StackInstall(false);
+    }
+
+    /**
+     * \param timer Timer accumulating the duration of each install step.
+     */
+    void SetTimer(SetupPhaseTimer* timer)
+    {
+        m_timer = timer;
+    }
+
+    /**
+     * \param wrapper Wrapper run around every per-node install step.
+     */
+    void SetNodeWrapper(NodeWrapper wrapper)
+    {
+        m_wrapper = wrapper;
+    }
+
+    /**
+     * Install all layers on the UEs.
+     * \param ueNodes The UE nodes.
+     */
+    void Install(NodeContainer ueNodes)
+    {
+        Ipv4StaticRoutingHelper ipv4RoutingHelper;
+        Ipv4Address gateway = m_epcHelper->GetUeDefaultGatewayAddress();
+
+        for (uint32_t first = 0; first < ueNodes.GetN(); first += m_batchSize)
+        {
+            uint32_t last = std::min(first + m_batchSize, ueNodes.GetN());
+            NetDeviceContainer batchDevs;
+
+            StartPhase("UE LTE devices");
+            for (uint32_t i = first; i < last; ++i)
+            {
+                Ptr<Node> ue = ueNodes.Get(i);
+                m_wrapper(ue, "LteUeNetDevice", [this, ue, &batchDevs]() {
+                    batchDevs.Add(m_lteHelper->InstallUeDevice(ue));
+                });
+            }
+
+            StartPhase("UE IPv4 stacks");
+            for (uint32_t i = first; i < last; ++i)
+            {
+                Ptr<Node> ue = ueNodes.Get(i);
+                m_wrapper(ue, "InternetStack (UE)", [this, ue]() { m_internet.Install(ue); });
+            }
+
+            StartPhase("UE addresses");
+            m_ueIpIfaces.Add(m_epcHelper->AssignUeIpv4Address(batchDevs));
+            for (uint32_t i = first; i < last; ++i)
+            {
+                Ptr<Ipv4StaticRouting> ueStaticRouting =
+                    ipv4RoutingHelper.GetStaticRouting(ueNodes.Get(i)->GetObject<Ipv4>());
+                ueStaticRouting->SetDefaultRoute(gateway, 1);
+            }
+            m_ueDevs.Add(batchDevs);
+        }
+        if (m_timer)
+        {
+            m_timer->Stop();
+        }
+    }
+
+    /// \return The UE LTE devices, in node order.
+    NetDeviceContainer GetUeDevices() const
+    {
+        return m_ueDevs;
+    }
+
+    /// \return The UE IPv4 interfaces, in node order.
+    Ipv4InterfaceContainer GetUeIpv4Interfaces() const
+    {
+        return m_ueIpIfaces;
+    }
+
+  private:
+    /**
+     * \param phase The install step starting.
+     */
+    void StartPhase(const std::string& phase)
+    {
+        if (m_timer)
+        {
+            m_timer->Start(phase);
+        }
+    }
+
+    Ptr<LteHelper> m_lteHelper;             //!< LTE helper
+    Ptr<PointToPointEpcHelper> m_epcHelper; //!< EPC helper
+    uint32_t m_batchSize;                   //!< UEs per batch
+    SetupPhaseTimer* m_timer;               //!< Phase timer, may be null
+    NodeWrapper m_wrapper;                  //!< Per-node install step wrapper
+    InternetStackHelper m_internet;         //!< IPv4-only stack helper
+    NetDeviceContainer m_ueDevs;            //!< Installed UE devices
+    Ipv4InterfaceContainer m_ueIpIfaces;    //!< Assigned UE interfaces
+};
+
+} // namespace ns3
+
+#endif // BULK_INSTALL_HELPER_H
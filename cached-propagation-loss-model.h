@@ -0,0 +1,284 @@
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include <ns3/core-module.h>
+#include <ns3/mobility-model.h>
+#include <ns3/propagation-loss-model.h>
+
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * Propagation loss model caching the loss of another model per link until
+ * one end of the link has moved more than DistanceThreshold.
+ *
+ * The spectrum channel asks for the loss of every link on every
+ * transmission, i.e. every TTI for the eNB control channel. This model keeps
+ * for each mobility model the position at which the losses involving it were
+ * last computed, and a counter that goes up each time the node gets further
+ * than DistanceThreshold from it. A link keeps the loss computed by the
+ * wrapped model (the Model attribute) until the counter of one of its ends
+ * changes.
+ *
+ * A hit is not free: with PositionResolution 0 it costs two GetPosition()
+ * calls, which make a mobile node update its position, two distances and
+ * three hash lookups. That is more than the closed-form models compute (one
+ * distance and a log10 for Friis), so the Model must be set, and the models
+ * of that kind (Friis, LogDistance, ThreeLogDistance, TwoRayGround, FixedRss
+ * and Range) are refused. The cache is meant for the models that cost more
+ * per call, e.g. the 3GPP or the buildings ones; it has not been measured
+ * against them.
+ *
+ * With PositionResolution set, positions themselves are only read from the
+ * mobility model once per resolution; in between, a moving node is assumed to
+ * be where it was last read. The error is then bounded by the UE speed times
+ * PositionResolution, plus DistanceThreshold.
+ *
+ * Random wrapped models (e.g. shadowing) are sampled once per cache entry,
+ * which makes their samples last until the threshold is crossed. Use it in
+ * place of the LTE pathloss model with
+ *
+ *   lteHelper->SetPathlossModelType(CachedPropagationLossModel::GetTypeId());
+ *   lteHelper->SetPathlossModelAttribute("Model",
+ *                                        StringValue("ns3::ThreeGppUmaPropagationLossModel"));
+ *   lteHelper->SetPathlossModelAttribute("DistanceThreshold", DoubleValue(1.0));
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+  public:
+    CachedPropagationLossModel()
+        : m_frequency(0),
+          m_hits(0),
+          m_misses(0)
+    {
+    }
+
+    ~CachedPropagationLossModel() override
+    {
+    }
+
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::CachedPropagationLossModel")
+                .SetParent<PropagationLossModel>()
+                .AddConstructor<CachedPropagationLossModel>()
+                .AddAttribute("Model",
+                              "TypeId of the propagation loss model whose losses are cached, "
+                              "not a closed-form one",
+                              StringValue(""),
+                              MakeStringAccessor(&CachedPropagationLossModel::m_modelType),
+                              MakeStringChecker())
+                .AddAttribute("DistanceThreshold",
+                              "Distance in m a node moves before its links are recomputed",
+                              DoubleValue(1.0),
+                              MakeDoubleAccessor(&CachedPropagationLossModel::m_threshold),
+                              MakeDoubleChecker<double>(0))
+                .AddAttribute("PositionResolution",
+                              "Time between two reads of a node position, 0 to read it on "
+                              "every use",
+                              TimeValue(Seconds(0)),
+                              MakeTimeAccessor(&CachedPropagationLossModel::m_resolution),
+                              MakeTimeChecker(Seconds(0)))
+                .AddAttribute("Frequency",
+                              "Carrier frequency in Hz passed on to the wrapped model, 0 to "
+                              "keep its own",
+                              DoubleValue(0),
+                              MakeDoubleAccessor(&CachedPropagationLossModel::SetFrequency,
+                                                 &CachedPropagationLossModel::GetFrequency),
+                              MakeDoubleChecker<double>(0));
+        return tid;
+    }
+
+    /**
+     * Set the carrier frequency of the wrapped model, as the LTE helper does
+     * for its pathloss models, and drop the cached losses.
+     * \param frequency The frequency in Hz.
+     */
+    void SetFrequency(double frequency)
+    {
+        m_frequency = frequency;
+        if (m_model && frequency > 0)
+        {
+            m_model->SetAttributeFailSafe("Frequency", DoubleValue(frequency));
+        }
+        m_links.clear();
+    }
+
+    /// \return The carrier frequency in Hz, 0 if not set.
+    double GetFrequency() const
+    {
+        return m_frequency;
+    }
+
+    /// \return The losses taken from the cache.
+    uint64_t GetHits() const
+    {
+        return m_hits;
+    }
+
+    /// \return The losses computed by the wrapped model.
+    uint64_t GetMisses() const
+    {
+        return m_misses;
+    }
+
+  protected:
+    void NotifyConstructionCompleted() override
+    {
+        PropagationLossModel::NotifyConstructionCompleted();
+        NS_ABORT_MSG_IF(m_modelType.empty(), "Set the Model whose losses are cached");
+        ObjectFactory factory(m_modelType);
+        m_model = factory.Create<PropagationLossModel>();
+        NS_ABORT_MSG_IF(!m_model, m_modelType << " is not a propagation loss model");
+        NS_ABORT_MSG_IF(IsClosedForm(m_model->GetInstanceTypeId()),
+                        m_modelType << " costs less than a cache lookup, use it directly");
+        SetFrequency(m_frequency);
+    }
+
+    void DoDispose() override
+    {
+        m_model = nullptr;
+        m_positions.clear();
+        m_links.clear();
+        PropagationLossModel::DoDispose();
+    }
+
+  private:
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override
+    {
+        uint32_t epochA = GetEpoch(a);
+        uint32_t epochB = GetEpoch(b);
+        Link& link = m_links[LinkKey(PeekPointer(a), PeekPointer(b))];
+        if (link.valid && link.epochA == epochA && link.epochB == epochB)
+        {
+            m_hits++;
+        }
+        else
+        {
+            m_misses++;
+            link.gainDb = m_model->CalcRxPower(0, a, b);
+            link.epochA = epochA;
+            link.epochB = epochB;
+            link.valid = true;
+        }
+        return txPowerDbm + link.gainDb;
+    }
+
+    int64_t DoAssignStreams(int64_t stream) override
+    {
+        return m_model->AssignStreams(stream);
+    }
+
+    /// Position state of one node
+    struct Position
+    {
+        Vector anchor;      //!< Position of the last recomputation
+        Time nextRead;      //!< Next read of the mobility model
+        uint32_t epoch = 0; //!< Bumped when the node leaves the anchor
+        bool valid = false; //!< Whether the anchor is set
+    };
+
+    /// Mobility models of the transmitter and the receiver of a link
+    typedef std::pair<MobilityModel*, MobilityModel*> LinkKey;
+
+    /// Cached loss of one link
+    struct Link
+    {
+        double gainDb = 0;   //!< Loss of the wrapped model, as a gain in dB
+        uint32_t epochA = 0; //!< Epoch of the transmitter when computed
+        uint32_t epochB = 0; //!< Epoch of the receiver when computed
+        bool valid = false;  //!< Whether gainDb is set
+    };
+
+    /// Hash of a link
+    struct LinkHash
+    {
+        /**
+         * \param link The mobility models of both ends.
+         * \return The hash.
+         */
+        size_t operator()(const LinkKey& link) const
+        {
+            auto a = reinterpret_cast<uintptr_t>(link.first);
+            auto b = reinterpret_cast<uintptr_t>(link.second);
+            return std::hash<uintptr_t>()(a * 0x9e3779b97f4a7c15ULL ^ b);
+        }
+    };
+
+    /**
+     * \param tid The TypeId of a propagation loss model.
+     * \return Whether the model is a formula of the distance, cheaper than the
+     *         cache itself.
+     */
+    static bool IsClosedForm(TypeId tid)
+    {
+        for (TypeId closedForm : {FriisPropagationLossModel::GetTypeId(),
+                                  LogDistancePropagationLossModel::GetTypeId(),
+                                  ThreeLogDistancePropagationLossModel::GetTypeId(),
+                                  TwoRayGroundPropagationLossModel::GetTypeId(),
+                                  FixedRssLossModel::GetTypeId(),
+                                  RangePropagationLossModel::GetTypeId()})
+        {
+            if (tid == closedForm)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Read the position of a node if due, and bump its epoch once it is
+     * further than the threshold from the last anchor.
+     *
+     * \param mobility The mobility model of the node.
+     * \return The epoch of the node.
+     */
+    uint32_t GetEpoch(Ptr<MobilityModel> mobility) const
+    {
+        Position& p = m_positions[PeekPointer(mobility)];
+        Time now = Simulator::Now();
+        if (p.valid && now < p.nextRead)
+        {
+            return p.epoch;
+        }
+        Vector position = mobility->GetPosition();
+        p.nextRead = now + m_resolution;
+        if (!p.valid)
+        {
+            p.anchor = position;
+            p.valid = true;
+        }
+        else if (CalculateDistance(position, p.anchor) > m_threshold)
+        {
+            p.anchor = position;
+            p.epoch++;
+        }
+        return p.epoch;
+    }
+
+    std::string m_modelType;           //!< TypeId of the wrapped model
+    double m_threshold;                //!< Distance threshold, in m
+    Time m_resolution;                 //!< Position read interval
+    double m_frequency;                //!< Frequency passed on, in Hz
+    Ptr<PropagationLossModel> m_model; //!< Wrapped model
+    mutable std::unordered_map<MobilityModel*, Position> m_positions; //!< Per node
+    mutable std::unordered_map<LinkKey, Link, LinkHash> m_links;       //!< Per link
+    mutable uint64_t m_hits;                                           //!< Cache hits
+    mutable uint64_t m_misses;                                         //!< Cache misses
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+
+} // namespace ns3
+
+#endif // CACHED_PROPAGATION_LOSS_MODEL_H
@@ -0,0 +1,325 @@
+#ifndef EARLY_STOP_CONTROLLER_H
+#define EARLY_STOP_CONTROLLER_H
+
+#include <ns3/core-module.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+
+namespace ns3
+{
+
+/**
+ * Stops the simulation once the chosen KPIs have settled.
+ *
+ * Every sampling interval each KPI is sampled (e.g. the throughput or the
+ * mean RLC delay over the last interval). The end of the warm-up transient
+ * of each series is found with MSER-5: samples are grouped by 5 and the
+ * truncation point minimising the standard error of the remaining mean is
+ * kept, provided it lies in the first half of the series. The rest of the
+ * series is cut into a fixed number of batches, and the confidence interval
+ * of the mean is computed from the batch means with a Student t quantile.
+ * Once the relative half-width of every KPI is below its target,
+ * Simulator::Stop() is called.
+ *
+ * The first analysis needs 2 * numBatches * minBatchSize samples (100 by
+ * default), so that the warm-up can take half of them. FitInterval()
+ * shortens the sampling interval for runs too short for that.
+ */
+class EarlyStopController
+{
+  public:
+    /**
+     * Returns the value of a KPI over the last sampling interval, or NaN if
+     * it is undefined for that interval (e.g. a delay without packets).
+     */
+    typedef std::function<double(Time interval)> Sampler;
+
+    /**
+     * \param sampleInterval Interval between two samples.
+     */
+    EarlyStopController(Time sampleInterval = MilliSeconds(100))
+        : m_sampleInterval(sampleInterval),
+          m_numBatches(10),
+          m_minBatchSize(5),
+          m_confidence(0.95),
+          m_stopTime(Seconds(0)),
+          m_stopped(false)
+    {
+    }
+
+    /**
+     * \param name The KPI name, for the report.
+     * \param sampler The KPI sampler.
+     * \param relativeHalfWidth Target half-width of the confidence interval,
+     *        relative to the mean.
+     */
+    void AddKpi(const std::string& name, Sampler sampler, double relativeHalfWidth)
+    {
+        Kpi kpi;
+        kpi.name = name;
+        kpi.sampler = sampler;
+        kpi.target = relativeHalfWidth;
+        m_kpis.push_back(kpi);
+    }
+
+    /**
+     * \param numBatches Number of batches of the batch means.
+     * \param minBatchSize Minimum number of samples per batch.
+     */
+    void SetBatches(uint32_t numBatches, uint32_t minBatchSize)
+    {
+        NS_ABORT_MSG_IF(numBatches < 2 || minBatchSize == 0, "Invalid batch configuration");
+        m_numBatches = numBatches;
+        m_minBatchSize = minBatchSize;
+    }
+
+    /**
+     * Shorten the sampling interval, down to 1 ms, so that the first
+     * analysis comes by the middle of the sampled time.
+     *
+     * \param span Time from the start of the sampling to the end of the run.
+     */
+    void FitInterval(Time span)
+    {
+        int64_t needed = 4 * m_numBatches * m_minBatchSize;
+        Time fitted = std::max(MilliSeconds(1), NanoSeconds(span.GetNanoSeconds() / needed));
+        m_sampleInterval = std::min(m_sampleInterval, fitted);
+    }
+
+    /// \return The sampling interval.
+    Time GetSampleInterval() const
+    {
+        return m_sampleInterval;
+    }
+
+    /**
+     * \param level Confidence level: 0.90, 0.95 or 0.99.
+     */
+    void SetConfidence(double level)
+    {
+        NormalQuantile(level); // validates the level
+        m_confidence = level;
+    }
+
+    /**
+     * Start sampling.
+     * \param at Time of the first sample, when the KPI sources are connected.
+     */
+    void Start(Time at)
+    {
+        Simulator::Schedule(at + m_sampleInterval, &EarlyStopController::Sample, this);
+    }
+
+    /// \return True if the controller stopped the simulation.
+    bool HasStopped() const
+    {
+        return m_stopped;
+    }
+
+    /**
+     * Print the warm-up, mean and confidence interval of each KPI.
+     * \param os The output stream.
+     */
+    void Print(std::ostream& os) const
+    {
+        if (m_stopped)
+        {
+            os << "Early stop at " << m_stopTime.As(Time::S);
+        }
+        else
+        {
+            os << "No early stop";
+        }
+        os << ", " << m_confidence * 100 << "% confidence intervals" << std::endl;
+        os << "  " << std::left << std::setw(24) << "KPI" << std::right << std::setw(10)
+           << "samples" << std::setw(12) << "warm-up [s]" << std::setw(14) << "mean"
+           << std::setw(14) << "half-width" << std::setw(10) << "settled" << std::endl;
+        for (const auto& kpi : m_kpis)
+        {
+            os << "  " << std::left << std::setw(24) << kpi.name << std::right << std::setw(10)
+               << kpi.samples.size() << std::setw(12)
+               << kpi.warmup * m_sampleInterval.GetSeconds() << std::setw(14) << kpi.mean
+               << std::setw(14) << kpi.halfWidth << std::setw(10) << (kpi.settled ? "yes" : "no")
+               << std::endl;
+        }
+    }
+
+  private:
+    /// State of one KPI
+    struct Kpi
+    {
+        std::string name;            //!< Name
+        Sampler sampler;             //!< Sampler
+        double target = 0;           //!< Target relative half-width
+        std::vector<double> samples; //!< Samples, including the warm-up
+        size_t warmup = 0;           //!< Samples in the warm-up transient
+        double mean = 0;             //!< Mean after the warm-up
+        double halfWidth = 0;        //!< Confidence interval half-width
+        bool settled = false;        //!< Whether the target is met
+    };
+
+    /// Sample the KPIs, and stop the simulation if they all settled
+    void Sample()
+    {
+        bool allSettled = true;
+        for (auto& kpi : m_kpis)
+        {
+            double value = kpi.sampler(m_sampleInterval);
+            if (std::isfinite(value))
+            {
+                kpi.samples.push_back(value);
+            }
+            allSettled = Analyse(kpi) && allSettled;
+        }
+        if (allSettled && !m_kpis.empty())
+        {
+            m_stopped = true;
+            m_stopTime = Simulator::Now();
+            Simulator::Stop();
+            return;
+        }
+        Simulator::Schedule(m_sampleInterval, &EarlyStopController::Sample, this);
+    }
+
+    /**
+     * Update the warm-up and the confidence interval of a KPI.
+     * \param kpi The KPI.
+     * \return Whether the KPI settled.
+     */
+    bool Analyse(Kpi& kpi) const
+    {
+        kpi.settled = false;
+        const std::vector<double>& x = kpi.samples;
+        if (x.size() < 2 * m_numBatches * m_minBatchSize)
+        {
+            return false;
+        }
+
+        // MSER-5 truncation point
+        const size_t groupSize = 5;
+        size_t numGroups = x.size() / groupSize;
+        std::vector<double> z(numGroups, 0);
+        for (size_t g = 0; g < numGroups; g++)
+        {
+            for (size_t i = 0; i < groupSize; i++)
+            {
+                z[g] += x[g * groupSize + i];
+            }
+            z[g] /= groupSize;
+        }
+        double s1 = 0;
+        double s2 = 0;
+        double best = std::numeric_limits<double>::max();
+        size_t bestD = 0;
+        for (size_t d = numGroups; d-- > 0;)
+        {
+            s1 += z[d];
+            s2 += z[d] * z[d];
+            size_t m = numGroups - d;
+            if (m > 1)
+            {
+                double mser = (s2 - s1 * s1 / m) / (static_cast<double>(m) * m);
+                if (mser <= best)
+                {
+                    best = mser;
+                    bestD = d;
+                }
+            }
+        }
+        kpi.warmup = bestD * groupSize;
+        if (bestD > numGroups / 2)
+        {
+            return false; // still in the transient
+        }
+
+        // Batch means over the rest of the series
+        size_t batchSize = (x.size() - kpi.warmup) / m_numBatches;
+        if (batchSize < m_minBatchSize)
+        {
+            return false;
+        }
+        std::vector<double> y(m_numBatches, 0);
+        for (uint32_t j = 0; j < m_numBatches; j++)
+        {
+            for (size_t i = 0; i < batchSize; i++)
+            {
+                y[j] += x[kpi.warmup + j * batchSize + i];
+            }
+            y[j] /= batchSize;
+        }
+        double mean = 0;
+        for (double v : y)
+        {
+            mean += v;
+        }
+        mean /= m_numBatches;
+        double var = 0;
+        for (double v : y)
+        {
+            var += (v - mean) * (v - mean);
+        }
+        var /= m_numBatches - 1;
+        kpi.mean = mean;
+        kpi.halfWidth = StudentQuantile(m_confidence, m_numBatches - 1) *
+                        std::sqrt(var / m_numBatches);
+        kpi.settled = kpi.halfWidth <= kpi.target * std::fabs(mean);
+        return kpi.settled;
+    }
+
+    /**
+     * \param level Two-sided confidence level.
+     * \return The matching standard normal quantile.
+     */
+    static double NormalQuantile(double level)
+    {
+        if (std::fabs(level - 0.90) < 1e-9)
+        {
+            return 1.644854;
+        }
+        if (std::fabs(level - 0.95) < 1e-9)
+        {
+            return 1.959964;
+        }
+        if (std::fabs(level - 0.99) < 1e-9)
+        {
+            return 2.575829;
+        }
+        NS_FATAL_ERROR("Unsupported confidence level " << level);
+        return 0;
+    }
+
+    /**
+     * Cornish-Fisher expansion of the Student t quantile, within 1e-3 of the
+     * exact value from 5 degrees of freedom on.
+     *
+     * \param level Two-sided confidence level.
+     * \param dof Degrees of freedom.
+     * \return The t quantile.
+     */
+    static double StudentQuantile(double level, uint32_t dof)
+    {
+        double z = NormalQuantile(level);
+        double n = dof;
+        double z3 = z * z * z;
+        double z5 = z3 * z * z;
+        double z7 = z5 * z * z;
+        return z + (z3 + z) / (4 * n) + (5 * z5 + 16 * z3 + 3 * z) / (96 * n * n) +
+               (3 * z7 + 19 * z5 + 17 * z3 - 15 * z) / (384 * n * n * n);
+    }
+
+    Time m_sampleInterval;   //!< Interval between samples
+    uint32_t m_numBatches;   //!< Number of batches
+    uint32_t m_minBatchSize; //!< Minimum samples per batch
+    double m_confidence;     //!< Confidence level
+    Time m_stopTime;         //!< Time of the early stop
+    bool m_stopped;          //!< Whether the controller stopped the run
+    std::vector<Kpi> m_kpis; //!< Tracked KPIs
+};
+
+} // namespace ns3
+
+#endif // EARLY_STOP_CONTROLLER_H
@@ -0,0 +1,35 @@
+#include "mmap-trace-fading-loss-model.h"
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/*
+ * Converts a text fading trace (as generated by the LTE module's
+ * fading-trace-generator.m) into the binary format mapped by
+ * MmapTraceFadingLossModel, e.g.
+ *
+ *   ./ns3 run "fading-trace-convert --input=fading_trace_EPA_3kmph.fad
+ *              --output=fading_trace_EPA_3kmph.bin"
+ */
+int main(int argc, char *argv[])
+{
+    std::string input = "fading_trace_EPA_3kmph.fad";
+    std::string output = "fading_trace_EPA_3kmph.bin";
+    uint32_t rbNum = 100;
+    uint32_t samplesNum = 10000;
+    double traceLength = 10.0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Text fading trace", input);
+    cmd.AddValue("output", "Binary fading trace", output);
+    cmd.AddValue("rbNum", "Number of RBs in the trace", rbNum);
+    cmd.AddValue("samplesNum", "Number of samples per RB in the trace", samplesNum);
+    cmd.AddValue("traceLength", "Duration of the trace in seconds", traceLength);
+    cmd.Parse(argc, argv);
+
+    MmapTraceFadingLossModel::ConvertTextTrace(input, output, rbNum, samplesNum, Seconds(traceLength));
+    std::cout << "Wrote " << output << " (" << rbNum << " RBs x " << samplesNum << " samples)"
+              << std::endl;
+    return 0;
+}
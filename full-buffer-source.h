@@ -0,0 +1,229 @@
+#ifndef FULL_BUFFER_SOURCE_H
+#define FULL_BUFFER_SOURCE_H
+
+#include <ns3/core-module.h>
+#include <ns3/internet-module.h>
+#include <ns3/lte-module.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * Saturated downlink on every data radio bearer, without the remote hosts,
+ * the UDP/IP stack of the sender, the PGW, SGW and the S1-U tunnel.
+ *
+ * The RLC SM entities of the LTE module would do this, but the LteHelper
+ * switches an eNB with an EPC back to RLC UM, and the UEs to UM as well, so
+ * this source writes to the PDCP of each bearer set up at an eNB instead:
+ * IPv4/UDP packets for the UE, which its IP stack delivers to a socket (the
+ * UDP sink of the scenario). It keeps about the MaxTxBufferSize of the RLC,
+ * less one packet, queued: the bearer starts with that much, and each PDU
+ * the RLC transmits is replaced by as many bytes of new packets.
+ *
+ * The PDCP and RLC headers make the RLC buffer grow slightly faster than the
+ * source counts, so the buffer creeps up to MaxTxBufferSize and the RLC then
+ * drops the odd packet (its TxDrop trace): the buffer never runs dry.
+ */
+class FullBufferSource
+{
+  public:
+    /**
+     * \param payloadSize The UDP payload of each packet, in bytes.
+     */
+    FullBufferSource(uint32_t payloadSize)
+        : m_payloadSize(payloadSize)
+    {
+    }
+
+    /**
+     * Send the packets of a UE to an address and port.
+     *
+     * \param imsi The IMSI of the UE.
+     * \param address The address of the UE.
+     * \param port The UDP port of its sink.
+     */
+    void AddUe(uint64_t imsi, Ipv4Address address, uint16_t port)
+    {
+        m_ues[imsi] = Ue{address, port};
+    }
+
+    /**
+     * Fill the data radio bearers set up from now on at the eNBs. To be
+     * called before the UEs attach.
+     *
+     * \param enbDevs The eNB devices.
+     * \param source The source address of the packets.
+     */
+    void Install(const NetDeviceContainer& enbDevs, Ipv4Address source)
+    {
+        m_source = source;
+        for (uint32_t i = 0; i < enbDevs.GetN(); i++)
+        {
+            Ptr<LteEnbNetDevice> enbDev = enbDevs.Get(i)->GetObject<LteEnbNetDevice>();
+            NS_ABORT_MSG_IF(!enbDev, "Device " << i << " is not an eNB");
+            Ptr<LteEnbRrc> rrc = enbDev->GetRrc();
+            rrc->TraceConnectWithoutContext(
+                "DrbCreated",
+                MakeBoundCallback(&FullBufferSource::DrbCreated, this, PeekPointer(rrc)));
+        }
+    }
+
+    /// \return The bytes of the packets written to the PDCP, headers included.
+    uint64_t GetSentBytes() const
+    {
+        return m_sentBytes;
+    }
+
+  private:
+    /// Destination of the packets of a UE
+    struct Ue
+    {
+        Ipv4Address address; //!< Address of the UE
+        uint16_t port = 0;   //!< UDP port of its sink
+    };
+
+    /// One bearer being filled
+    struct Bearer : public SimpleRefCount<Bearer>
+    {
+        FullBufferSource* source = nullptr; //!< Source
+        Ue ue;                              //!< Destination of the packets
+        Ptr<LtePdcp> pdcp;                  //!< PDCP of the bearer
+        uint16_t rnti = 0;                  //!< RNTI
+        uint8_t lcid = 0;                   //!< Logical channel
+        int64_t backlog = 0;                //!< Bytes to keep queued
+        int64_t queued = 0;                 //!< Bytes written and not transmitted yet
+        bool refillPending = false;         //!< Whether a refill is scheduled
+    };
+
+    /**
+     * A DRB was set up at an eNB: fill it, and refill it after each PDU.
+     *
+     * \param source The source.
+     * \param rrc The RRC of the eNB, not held: it would hold itself.
+     * \param imsi The IMSI.
+     * \param cellId The cell.
+     * \param rnti The RNTI.
+     * \param lcid The logical channel.
+     */
+    static void DrbCreated(FullBufferSource* source,
+                           LteEnbRrc* rrc,
+                           uint64_t imsi,
+                           uint16_t /* cellId */,
+                           uint16_t rnti,
+                           uint8_t lcid)
+    {
+        auto ue = source->m_ues.find(imsi);
+        if (ue == source->m_ues.end())
+        {
+            return;
+        }
+        // DRB ids are the LCIDs minus the two SRBs
+        ObjectMapValue drbs;
+        rrc->GetUeManager(rnti)->GetAttribute("DataRadioBearerMap", drbs);
+        Ptr<LteDataRadioBearerInfo> drb = DynamicCast<LteDataRadioBearerInfo>(drbs.Get(lcid - 2));
+        NS_ABORT_MSG_IF(!drb || !drb->m_pdcp,
+                        "No DRB with a PDCP for LCID " << +lcid << " of RNTI " << rnti);
+        UintegerValue maxTxBufferSize;
+        drb->m_rlc->GetAttribute("MaxTxBufferSize", maxTxBufferSize);
+
+        Ptr<Bearer> bearer = Create<Bearer>();
+        bearer->source = source;
+        bearer->ue = ue->second;
+        bearer->pdcp = drb->m_pdcp;
+        bearer->rnti = rnti;
+        bearer->lcid = lcid;
+        int64_t packetSize = source->GetPacketSize();
+        bearer->backlog =
+            std::max<int64_t>(int64_t(maxTxBufferSize.Get()) - packetSize, packetSize);
+        // The callback holds the bearer: it goes with the RLC
+        drb->m_rlc->TraceConnectWithoutContext("TxPDU",
+                                               MakeBoundCallback(&FullBufferSource::TxPdu, bearer));
+        ScheduleRefill(bearer);
+    }
+
+    /**
+     * The RLC of a bearer transmitted a PDU.
+     *
+     * \param bearer The bearer.
+     * \param rnti The RNTI.
+     * \param lcid The logical channel.
+     * \param bytes The PDU size.
+     */
+    static void TxPdu(Ptr<Bearer> bearer, uint16_t /* rnti */, uint8_t /* lcid */, uint32_t bytes)
+    {
+        bearer->queued = std::max<int64_t>(bearer->queued - bytes, 0);
+        ScheduleRefill(bearer);
+    }
+
+    /**
+     * Refill a bearer once the current event is over: the RLC calls its
+     * traces in the middle of a transmission opportunity.
+     *
+     * \param bearer The bearer.
+     */
+    static void ScheduleRefill(Ptr<Bearer> bearer)
+    {
+        if (!bearer->refillPending)
+        {
+            bearer->refillPending = true;
+            Simulator::ScheduleNow(&FullBufferSource::Refill, bearer);
+        }
+    }
+
+    /**
+     * Write packets to the PDCP of a bearer up to its backlog.
+     *
+     * \param bearer The bearer.
+     */
+    static void Refill(Ptr<Bearer> bearer)
+    {
+        bearer->refillPending = false;
+        // Only this source still holds the PDCP once the eNB released the
+        // bearer, its RLC with it
+        if (bearer->pdcp->GetReferenceCount() == 1)
+        {
+            return;
+        }
+        FullBufferSource* source = bearer->source;
+        LtePdcpSapProvider::TransmitPdcpSduParameters params;
+        params.rnti = bearer->rnti;
+        params.lcid = bearer->lcid;
+        while (bearer->queued < bearer->backlog)
+        {
+            Ptr<Packet> packet = Create<Packet>(source->m_payloadSize);
+            UdpHeader udp;
+            udp.SetSourcePort(bearer->ue.port);
+            udp.SetDestinationPort(bearer->ue.port);
+            packet->AddHeader(udp);
+            Ipv4Header ip;
+            ip.SetSource(source->m_source);
+            ip.SetDestination(bearer->ue.address);
+            ip.SetProtocol(UdpL4Protocol::PROT_NUMBER);
+            ip.SetPayloadSize(packet->GetSize());
+            ip.SetTtl(64);
+            packet->AddHeader(ip);
+            params.pdcpSdu = packet;
+            bearer->pdcp->GetLtePdcpSapProvider()->TransmitPdcpSdu(params);
+            bearer->queued += packet->GetSize();
+            source->m_sentBytes += packet->GetSize();
+        }
+    }
+
+    /// \return The size of an IPv4/UDP packet.
+    uint32_t GetPacketSize() const
+    {
+        return m_payloadSize + 8 + 20;
+    }
+
+    uint32_t m_payloadSize;                 //!< UDP payload of each packet
+    Ipv4Address m_source;                   //!< Source address of the packets
+    std::unordered_map<uint64_t, Ue> m_ues; //!< Destinations, by IMSI
+    uint64_t m_sentBytes = 0;               //!< Bytes written to the PDCP
+};
+
+} // namespace ns3
+
+#endif // FULL_BUFFER_SOURCE_H
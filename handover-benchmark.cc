@@ -0,0 +1,195 @@
+#include "topk-a2a4-rsrq-handover-algorithm.h"
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+using namespace ns3;
+
+/*
+ * Compares the eNB side measurement processing of A2A4RsrqHandoverAlgorithm
+ * and TopKA2A4RsrqHandoverAlgorithm as the number of cells grows.
+ *
+ * The cells sit on a ring and every UE goes once around it during the run,
+ * the way UEs cross the whole area in a long run. Each UE alternates A4
+ * reports, listing its reportedCells strongest neighbours best first as the
+ * UE RRC does, and A2 reports of its serving cell. Both algorithms get the
+ * very same reports, MaxNeighbourCells neighbours each by default, so the
+ * times compare the processing of the same input and the handover counts
+ * show where the decisions differ. In a scenario the UEs report 8 neighbours
+ * to A2A4Rsrq; run it with reportedCells=8 for that load, the top-K variant
+ * then keeps the best K of them. The reports are fed straight to the
+ * handover management SAP, so the time per report is the algorithm alone.
+ * The UE side (LteUeRrc measuring every detected cell) is not part of it.
+ */
+
+/// Handover management SAP user counting the handovers
+class CountingSapUser : public LteHandoverManagementSapUser
+{
+  public:
+    std::vector<uint8_t> AddUeMeasReportConfigForHandover(
+        LteRrcSap::ReportConfigEutra /* reportConfig */) override
+    {
+        return {m_nextMeasId++};
+    }
+
+    void TriggerHandover(uint16_t /* rnti */, uint16_t /* targetCellId */) override
+    {
+        m_handovers++;
+    }
+
+    uint8_t m_nextMeasId = 1; //!< Next measurement id
+    uint64_t m_handovers = 0; //!< Triggered handovers
+};
+
+/**
+ * RSRQ range of a cell seen from a position on the ring.
+ *
+ * \param position UE position, in cells.
+ * \param cellIndex Cell index.
+ * \param numCells Number of cells.
+ * \return The RSRQ range, 34 at the cell site.
+ */
+uint8_t Rsrq(double position, uint32_t cellIndex, uint32_t numCells)
+{
+    double d = std::fabs(position - cellIndex);
+    d = std::min(d, numCells - d);
+    return static_cast<uint8_t>(std::max(0.0, 34 - 8 * d));
+}
+
+/**
+ * Feed the reports of all UEs to one algorithm.
+ *
+ * \param algorithm The handover algorithm.
+ * \param numCells Number of cells on the ring.
+ * \param numUes Number of UEs.
+ * \param reports A4 and A2 report pairs per UE.
+ * \param reportedCells Neighbours in each A4 report.
+ * \param handovers Set to the number of triggered handovers.
+ * \return The wall clock time per report, in ns.
+ */
+double RunReports(Ptr<LteHandoverAlgorithm> algorithm,
+                  uint32_t numCells,
+                  uint32_t numUes,
+                  uint32_t reports,
+                  uint32_t reportedCells,
+                  uint64_t& handovers)
+{
+    CountingSapUser user;
+    algorithm->SetLteHandoverManagementSapUser(&user);
+    algorithm->Initialize(); // measIds: 1 for A2, 2 for A4
+    LteHandoverManagementSapProvider* sap = algorithm->GetLteHandoverManagementSapProvider();
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+    std::vector<double> start(numUes);
+    for (auto& s : start)
+    {
+        s = rv->GetValue(0, numCells);
+    }
+
+    std::chrono::steady_clock::duration elapsed{};
+    for (uint32_t r = 0; r < reports; r++)
+    {
+        for (uint32_t u = 0; u < numUes; u++)
+        {
+            double position = std::fmod(start[u] + numCells * double(r) / reports, numCells);
+            uint32_t serving = static_cast<uint32_t>(std::lround(position)) % numCells;
+
+            LteRrcSap::MeasResults a4;
+            a4.measId = 2;
+            a4.haveMeasResultNeighCells = true;
+            a4.haveMeasResultServFreqList = false;
+            for (uint32_t k = 1; k <= reportedCells / 2 + 1; k++)
+            {
+                for (uint32_t cell : {serving + k, serving + numCells - k})
+                {
+                    cell %= numCells;
+                    if (a4.measResultListEutra.size() == reportedCells || cell == serving)
+                    {
+                        continue;
+                    }
+                    LteRrcSap::MeasResultEutra m;
+                    m.physCellId = cell + 1;
+                    m.haveCgiInfo = false;
+                    m.haveRsrpResult = false;
+                    m.haveRsrqResult = true;
+                    m.rsrqResult = Rsrq(position, cell, numCells);
+                    a4.measResultListEutra.push_back(m);
+                }
+            }
+
+            LteRrcSap::MeasResults a2;
+            a2.measId = 1;
+            a2.measResultPCell.rsrpResult = 0;
+            // A2 reports only come below the serving cell threshold
+            a2.measResultPCell.rsrqResult =
+                std::min<uint8_t>(30, Rsrq(position, serving, numCells));
+            a2.haveMeasResultNeighCells = false;
+            a2.haveMeasResultServFreqList = false;
+
+            auto begin = std::chrono::steady_clock::now();
+            sap->ReportUeMeas(u + 1, a4);
+            sap->ReportUeMeas(u + 1, a2);
+            elapsed += std::chrono::steady_clock::now() - begin;
+        }
+    }
+    handovers = user.m_handovers;
+    algorithm->Dispose();
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (2.0 * reports * numUes);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string cellsList = "16,64,256,1024";
+    uint32_t numUes = 1000;
+    uint32_t reports = 200;
+    uint32_t maxNeighbourCells = 4;
+    uint32_t reportedCells = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("cells", "Comma separated numbers of cells", cellsList);
+    cmd.AddValue("numUes", "Number of UEs", numUes);
+    cmd.AddValue("reports", "A4 and A2 report pairs per UE", reports);
+    cmd.AddValue("maxNeighbourCells", "K of the top-K algorithm", maxNeighbourCells);
+    cmd.AddValue("reportedCells",
+                 "Neighbours in each A4 report, for both algorithms (0: maxNeighbourCells)",
+                 reportedCells);
+    cmd.Parse(argc, argv);
+    if (reportedCells == 0)
+    {
+        reportedCells = maxNeighbourCells;
+    }
+    NS_ABORT_MSG_IF(reportedCells > LteRrcSap::MaxReportCells,
+                    "A report lists at most " << +LteRrcSap::MaxReportCells << " cells");
+
+    std::cout << std::left << std::setw(8) << "cells" << std::setw(36) << "algorithm"
+              << std::setw(14) << "ns/report" << "handovers" << std::endl;
+    std::istringstream iss(cellsList);
+    std::string token;
+    while (std::getline(iss, token, ','))
+    {
+        uint32_t numCells = std::stoul(token);
+        uint64_t handovers = 0;
+        double ns = RunReports(CreateObject<A2A4RsrqHandoverAlgorithm>(),
+                               numCells,
+                               numUes,
+                               reports,
+                               reportedCells,
+                               handovers);
+        std::cout << std::left << std::setw(8) << numCells << std::setw(36)
+                  << "ns3::A2A4RsrqHandoverAlgorithm" << std::setw(14) << std::fixed
+                  << std::setprecision(0) << ns << handovers << std::endl;
+
+        Ptr<TopKA2A4RsrqHandoverAlgorithm> topK = CreateObject<TopKA2A4RsrqHandoverAlgorithm>();
+        topK->SetAttribute("MaxNeighbourCells", UintegerValue(maxNeighbourCells));
+        ns = RunReports(topK, numCells, numUes, reports, reportedCells, handovers);
+        std::cout << std::left << std::setw(8) << numCells << std::setw(36)
+                  << "ns3::TopKA2A4RsrqHandoverAlgorithm" << std::setw(14) << std::fixed
+                  << std::setprecision(0) << ns << handovers << std::endl;
+    }
+    return 0;
+}
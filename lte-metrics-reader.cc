@@ -0,0 +1,139 @@
+#include "shm-metrics.h"
+
+#include "ns3/core-module.h"
+
+#include <cctype>
+#include <iomanip>
+#include <thread>
+
+using namespace ns3;
+
+/*
+ * Watches the metrics a running lte-scenario publishes with
+ * --metricsShmName, without touching the simulation process, e.g.
+ *
+ *   ./ns3 run "lte-metrics-reader --shmName=/lte-metrics --interval=2"
+ *
+ * prints every 2 seconds the simulation speed, the events per second, the
+ * gauges and the rate of the counters per simulated second, until the
+ * simulation ends. --format=prometheus prints the raw values once in the
+ * Prometheus text format, for a scraper to call.
+ */
+
+/**
+ * \param name A metric name.
+ * \return The name with the characters Prometheus does not accept replaced.
+ */
+static std::string
+PrometheusName(const std::string& name)
+{
+    std::string out = "lte_";
+    for (char c : name)
+    {
+        out += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    return out;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string shmName = "/lte-metrics";
+    double interval = 1.0;
+    uint32_t count = 0;
+    std::string format = "table";
+    double waitTime = 10.0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("shmName", "Shared memory segment of the simulation", shmName);
+    cmd.AddValue("interval", "Seconds between two reports", interval);
+    cmd.AddValue("count", "Number of reports, 0 until the simulation ends", count);
+    cmd.AddValue("format", "table or prometheus (one raw snapshot)", format);
+    cmd.AddValue("waitTime", "Seconds to wait for the simulation to publish", waitTime);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(format != "table" && format != "prometheus", "Unknown format " << format);
+
+    ShmMetricsReader reader;
+    ShmMetricsReader::Snapshot last;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(waitTime);
+    while (!reader.Open(shmName))
+    {
+        NS_ABORT_MSG_IF(std::chrono::steady_clock::now() > deadline,
+                        "No metrics published in " << shmName);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    while (!reader.Read(last))
+    {
+        NS_ABORT_MSG_IF(!reader.IsPublisherAlive(),
+                        "Process " << reader.GetPid() << " ended without publishing");
+        NS_ABORT_MSG_IF(std::chrono::steady_clock::now() > deadline,
+                        "No metrics published in " << shmName);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    if (format == "prometheus")
+    {
+        std::cout << "lte_sim_time_seconds " << last.simTime / 1e9 << std::endl;
+        std::cout << "lte_events_total " << last.eventCount << std::endl;
+        for (uint32_t i = 0; i < reader.GetN(); i++)
+        {
+            std::cout << PrometheusName(reader.GetName(i)) << " " << last.values[i] << std::endl;
+        }
+        return 0;
+    }
+
+    std::cout << "Metrics of process " << reader.GetPid() << " in " << shmName << std::endl;
+    for (uint32_t n = 0; count == 0 || n < count; n++)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+        ShmMetricsReader::Snapshot now;
+        if (!reader.Read(now))
+        {
+            // A publisher that died in an update leaves the segment locked
+            NS_ABORT_MSG_IF(!reader.IsPublisherAlive(),
+                            "Process " << reader.GetPid() << " ended in an update");
+            std::cout << "No consistent snapshot within 1 s" << std::endl;
+            continue;
+        }
+        double wall = (now.wallTime - last.wallTime) / 1e9;
+        double sim = (now.simTime - last.simTime) / 1e9;
+
+        std::cout << "t=" << std::fixed << std::setprecision(3) << now.simTime / 1e9 << " s";
+        if (wall > 0)
+        {
+            std::cout << "  speed " << sim / wall << " sim s/s  "
+                      << std::setprecision(0) << (now.eventCount - last.eventCount) / wall
+                      << " events/s";
+        }
+        std::cout << std::endl;
+        for (uint32_t i = 0; i < reader.GetN(); i++)
+        {
+            std::cout << "  " << std::left << std::setw(40) << reader.GetName(i) << std::right
+                      << std::setprecision(3) << std::setw(16);
+            if (!reader.IsCounter(i))
+            {
+                std::cout << now.values[i] << std::endl;
+            }
+            else if (sim > 0)
+            {
+                std::cout << (now.values[i] - last.values[i]) / sim << " /s" << std::endl;
+            }
+            else
+            {
+                std::cout << "-" << std::endl;
+            }
+        }
+        last = now;
+        if (now.finished)
+        {
+            std::cout << "Simulation finished" << std::endl;
+            break;
+        }
+        if (!reader.IsPublisherAlive())
+        {
+            std::cout << "Process " << reader.GetPid() << " ended before the end of the simulation"
+                      << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,473 @@
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+/*
+ * Tracks the performance of lte-scenario on a fixed set of canonical
+ * scenarios: small, medium and large deployments, with and without the
+ * statistics traces and the LTE error models. Each scenario runs several
+ * times in its own directory under workDir, and the median wall time,
+ * events per second of Simulator::Run() and peak RSS are compared with a
+ * JSON baseline, e.g. after an ns-3 upgrade:
+ *
+ *   ./ns3 run "lte-perf-regression --update --label=ns-3.39
+ *              --program=build/scratch/ns3.39-lte-scenario-optimized"
+ *   ./ns3 run "lte-perf-regression
+ *              --program=build/scratch/ns3.40-lte-scenario-optimized"
+ *
+ * The first command writes perf-baseline.json, to be committed with the
+ * scenarios it measures. The second prints the changes of every metric and
+ * exits with status 1 if one of them regressed by more than its threshold.
+ * The events executed are stored as well: when they change, the scenario
+ * itself changed and the baseline needs an update.
+ */
+
+/// A canonical scenario
+struct PerfScenario
+{
+    std::string name;              //!< Name in the baseline
+    std::vector<std::string> args; //!< lte-scenario arguments
+};
+
+/// Metrics of one scenario, medians over the runs
+struct PerfMetrics
+{
+    double wallTime = 0;        //!< Process wall time, in s
+    double eventsPerSecond = 0; //!< Events per second of Simulator::Run()
+    double peakRssKb = 0;       //!< Peak resident set size, in KiB
+    double events = 0;          //!< Events executed
+};
+
+/**
+ * \return The canonical scenarios, sizes times traces times error models.
+ */
+static std::vector<PerfScenario>
+CanonicalScenarios()
+{
+    const std::vector<std::pair<std::string, std::vector<std::string>>> sizes = {
+        {"small", {"--numEnbs=4", "--numUes=40"}},
+        {"medium", {"--numEnbs=16", "--numUes=400"}},
+        {"large", {"--numEnbs=64", "--numUes=2000"}},
+    };
+    const std::vector<std::string> noTraces = {"--rlcTraces=false",
+                                               "--pdcpTraces=false",
+                                               "--phyTraces=false",
+                                               "--macTraces=false",
+                                               "--throughputTrace=false"};
+    const std::vector<std::string> noErrorModels = {
+        "--ns3::LteSpectrumPhy::DataErrorModelEnabled=false",
+        "--ns3::LteSpectrumPhy::CtrlErrorModelEnabled=false"};
+
+    std::vector<PerfScenario> scenarios;
+    for (const auto& size : sizes)
+    {
+        for (bool traces : {true, false})
+        {
+            for (bool errorModels : {true, false})
+            {
+                PerfScenario scenario;
+                scenario.name = size.first + (traces ? "_traces" : "_notraces") +
+                                (errorModels ? "_err" : "_noerr");
+                scenario.args = {"--ueLayout=cell",
+                                 "--attachMode=closest",
+                                 "--dlTraffic=true",
+                                 "--packetInterval=10ms",
+                                 "--RngRun=1"};
+                scenario.args.insert(scenario.args.end(), size.second.begin(), size.second.end());
+                if (!traces)
+                {
+                    scenario.args.insert(scenario.args.end(), noTraces.begin(), noTraces.end());
+                }
+                if (!errorModels)
+                {
+                    scenario.args.insert(scenario.args.end(),
+                                         noErrorModels.begin(),
+                                         noErrorModels.end());
+                }
+                scenarios.push_back(scenario);
+            }
+        }
+    }
+    return scenarios;
+}
+
+/**
+ * Run lte-scenario once in a directory.
+ *
+ * \param program The lte-scenario executable.
+ * \param args Its arguments.
+ * \param dir The run directory, where its output goes to output.txt.
+ * \return The metrics of the run.
+ */
+static PerfMetrics
+RunOnce(const std::string& program, const std::vector<std::string>& args, const std::string& dir)
+{
+    auto begin = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    NS_ABORT_MSG_IF(pid < 0, "Cannot fork " << program);
+    if (pid == 0)
+    {
+        if (chdir(dir.c_str()) != 0 || !std::freopen("output.txt", "w", stdout) ||
+            dup2(fileno(stdout), STDERR_FILENO) < 0)
+        {
+            _exit(127);
+        }
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(program.c_str()));
+        for (const auto& arg : args)
+        {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        execv(program.c_str(), argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    NS_ABORT_MSG_IF(wait4(pid, &status, 0, &usage) != pid, "Lost the run in " << dir);
+    PerfMetrics metrics;
+    metrics.wallTime =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    metrics.peakRssKb = usage.ru_maxrss;
+    NS_ABORT_MSG_IF(!WIFEXITED(status) || WEXITSTATUS(status) != 0,
+                    program << " failed in " << dir << ", see " << dir << "/output.txt");
+
+    // The Simulator::Run() phase of the setup timer and the event count
+    std::ifstream output(dir + "/output.txt");
+    std::string line;
+    double runTime = 0;
+    while (std::getline(output, line))
+    {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+        if (word == "Simulator::Run")
+        {
+            iss >> runTime;
+        }
+        else if (line.rfind("Events executed:", 0) == 0)
+        {
+            metrics.events = std::stod(line.substr(16));
+        }
+    }
+    NS_ABORT_MSG_IF(runTime <= 0 || metrics.events <= 0,
+                    "No run time or event count in " << dir << "/output.txt");
+    metrics.eventsPerSecond = metrics.events / runTime;
+    return metrics;
+}
+
+/**
+ * \param values Some values, reordered.
+ * \return Their median.
+ */
+static double
+Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+/**
+ * Minimal reader of the baseline JSON: objects, strings and numbers, with
+ * every number stored under its dotted path (scenarios.small_traces_err.wallTime).
+ */
+class BaselineReader
+{
+  public:
+    /**
+     * \param text The JSON text.
+     * \param fileName The file, for the error messages.
+     */
+    BaselineReader(const std::string& text, const std::string& fileName)
+        : m_text(text),
+          m_fileName(fileName),
+          m_pos(0)
+    {
+        Value("");
+    }
+
+    /**
+     * \param path The dotted path of a number.
+     * \return Whether the baseline has it.
+     */
+    bool HasNumber(const std::string& path) const
+    {
+        return m_numbers.count(path) > 0;
+    }
+
+    /**
+     * \param path The dotted path of a number.
+     * \return The number, 0 if missing.
+     */
+    double GetNumber(const std::string& path) const
+    {
+        auto it = m_numbers.find(path);
+        return it != m_numbers.end() ? it->second : 0;
+    }
+
+    /**
+     * \param path The dotted path of a string.
+     * \return The string, empty if missing.
+     */
+    std::string GetString(const std::string& path) const
+    {
+        auto it = m_strings.find(path);
+        return it != m_strings.end() ? it->second : "";
+    }
+
+  private:
+    /// Skip the white space.
+    void Skip()
+    {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+        {
+            m_pos++;
+        }
+    }
+
+    /**
+     * \param c The expected character, after white space.
+     */
+    void Expect(char c)
+    {
+        Skip();
+        NS_ABORT_MSG_IF(m_pos == m_text.size() || m_text[m_pos] != c,
+                        m_fileName << ": expected '" << c << "' at offset " << m_pos);
+        m_pos++;
+    }
+
+    /// \return The next string, without escapes.
+    std::string String()
+    {
+        Expect('"');
+        size_t end = m_text.find('"', m_pos);
+        NS_ABORT_MSG_IF(end == std::string::npos, m_fileName << ": unterminated string");
+        std::string s = m_text.substr(m_pos, end - m_pos);
+        m_pos = end + 1;
+        return s;
+    }
+
+    /**
+     * Read a value and store it under its path.
+     * \param path The dotted path of the value.
+     */
+    void Value(const std::string& path)
+    {
+        Skip();
+        NS_ABORT_MSG_IF(m_pos == m_text.size(), m_fileName << " is truncated");
+        if (m_text[m_pos] == '{')
+        {
+            m_pos++;
+            Skip();
+            if (m_text[m_pos] == '}')
+            {
+                m_pos++;
+                return;
+            }
+            do
+            {
+                std::string key = String();
+                Expect(':');
+                Value(path.empty() ? key : path + "." + key);
+                Skip();
+            } while (m_pos < m_text.size() && m_text[m_pos++] == ',');
+            NS_ABORT_MSG_IF(m_text[m_pos - 1] != '}', m_fileName << ": expected '}'");
+        }
+        else if (m_text[m_pos] == '"')
+        {
+            m_strings[path] = String();
+        }
+        else
+        {
+            size_t length = 0;
+            m_numbers[path] = std::stod(m_text.substr(m_pos), &length);
+            m_pos += length;
+        }
+    }
+
+    const std::string& m_text;                    //!< JSON text
+    const std::string& m_fileName;                //!< Baseline file name
+    size_t m_pos;                                 //!< Read offset
+    std::map<std::string, double> m_numbers;      //!< Numbers by path
+    std::map<std::string, std::string> m_strings; //!< Strings by path
+};
+
+int main(int argc, char *argv[])
+{
+    std::string program = "";
+    std::string baseline = "perf-baseline.json";
+    bool update = false;
+    std::string label = "";
+    uint32_t runs = 3;
+    std::string scenarioList = "";
+    std::string simTime = "2s";
+    double threshold = 0.10;
+    double rssThreshold = 0.05;
+    std::string workDir = "perf-runs";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("program", "lte-scenario executable", program);
+    cmd.AddValue("baseline", "JSON baseline file", baseline);
+    cmd.AddValue("update", "Write the baseline instead of comparing with it", update);
+    cmd.AddValue("label", "Label stored in the baseline, e.g. the ns-3 version", label);
+    cmd.AddValue("runs", "Runs per scenario, the metrics are their medians", runs);
+    cmd.AddValue("scenarios", "Comma separated scenarios to run, empty for all", scenarioList);
+    cmd.AddValue("simTime", "Simulated time of each run", simTime);
+    cmd.AddValue("threshold", "Relative wall time and event rate regression allowed", threshold);
+    cmd.AddValue("rssThreshold", "Relative peak RSS regression allowed", rssThreshold);
+    cmd.AddValue("workDir", "Directory of the run outputs", workDir);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(program.empty(), "No lte-scenario executable given, see --program");
+    NS_ABORT_MSG_IF(runs == 0, "At least one run per scenario is needed");
+    char* cwd = getcwd(nullptr, 0);
+    if (program[0] != '/')
+    {
+        // The runs happen in their own directories
+        program = std::string(cwd) + "/" + program;
+    }
+    free(cwd);
+
+    std::vector<PerfScenario> scenarios;
+    for (const auto& scenario : CanonicalScenarios())
+    {
+        if (scenarioList.empty() || ("," + scenarioList + ",").find("," + scenario.name + ",") !=
+                                        std::string::npos)
+        {
+            scenarios.push_back(scenario);
+        }
+    }
+    NS_ABORT_MSG_IF(scenarios.empty(), "No scenario matches " << scenarioList);
+
+    std::map<std::string, PerfMetrics> current;
+    NS_ABORT_MSG_IF(mkdir(workDir.c_str(), 0755) != 0 && errno != EEXIST,
+                    "Cannot create " << workDir);
+    for (auto& scenario : scenarios)
+    {
+        scenario.args.push_back("--simTime=" + simTime);
+        std::vector<double> wallTimes;
+        std::vector<double> rates;
+        std::vector<double> rss;
+        std::vector<double> events;
+        for (uint32_t r = 0; r < runs; r++)
+        {
+            std::string dir = workDir + "/" + scenario.name + "_" + std::to_string(r);
+            NS_ABORT_MSG_IF(mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST,
+                            "Cannot create " << dir);
+            PerfMetrics m = RunOnce(program, scenario.args, dir);
+            wallTimes.push_back(m.wallTime);
+            rates.push_back(m.eventsPerSecond);
+            rss.push_back(m.peakRssKb);
+            events.push_back(m.events);
+        }
+        PerfMetrics& median = current[scenario.name];
+        median.wallTime = Median(wallTimes);
+        median.eventsPerSecond = Median(rates);
+        median.peakRssKb = Median(rss);
+        median.events = Median(events);
+        std::cout << std::left << std::setw(24) << scenario.name << std::fixed
+                  << std::setprecision(2) << median.wallTime << " s, " << std::setprecision(0)
+                  << median.eventsPerSecond << " events/s, " << median.peakRssKb << " KiB"
+                  << std::endl;
+    }
+
+    if (update)
+    {
+        std::ofstream out(baseline, std::ios::trunc);
+        NS_ABORT_MSG_IF(!out.good(), "Cannot write " << baseline);
+        out << "{\n  \"version\": 1,\n  \"label\": \"" << label << "\",\n  \"runs\": " << runs
+            << ",\n  \"simTime\": \"" << simTime << "\",\n  \"scenarios\": {";
+        const char* separator = "\n";
+        for (const auto& s : current)
+        {
+            out << separator << "    \"" << s.first << "\": {\"wallTime\": " << std::fixed
+                << std::setprecision(3) << s.second.wallTime
+                << ", \"eventsPerSecond\": " << std::setprecision(0) << s.second.eventsPerSecond
+                << ", \"peakRssKb\": " << s.second.peakRssKb << ", \"events\": " << s.second.events
+                << "}";
+            separator = ",\n";
+        }
+        out << "\n  }\n}\n";
+        std::cout << "Baseline written to " << baseline << std::endl;
+        return 0;
+    }
+
+    std::ifstream in(baseline);
+    NS_ABORT_MSG_IF(!in.good(), "Baseline " << baseline << " not found, write it with --update");
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    BaselineReader base(text, baseline);
+    NS_ABORT_MSG_IF(base.GetNumber("version") != 1, baseline << " has an unknown version");
+    NS_ABORT_MSG_IF(base.GetString("simTime") != simTime,
+                    baseline << " was measured with simTime=" << base.GetString("simTime"));
+    std::cout << "Baseline " << baseline << " (" << base.GetString("label") << ")" << std::endl;
+
+    // Higher is better for the event rate only
+    struct Metric
+    {
+        std::string name;           //!< Name in the baseline
+        double PerfMetrics::*value; //!< Field of the metric
+        double threshold;           //!< Relative regression allowed
+        bool higherIsBetter;        //!< Direction of an improvement
+    };
+    const std::vector<Metric> metrics = {
+        {"wallTime", &PerfMetrics::wallTime, threshold, false},
+        {"eventsPerSecond", &PerfMetrics::eventsPerSecond, threshold, true},
+        {"peakRssKb", &PerfMetrics::peakRssKb, rssThreshold, false},
+    };
+    uint32_t regressions = 0;
+    std::cout << std::left << std::setw(24) << "scenario" << std::setw(18) << "metric"
+              << std::right << std::setw(14) << "baseline" << std::setw(14) << "current"
+              << std::setw(10) << "change" << std::endl;
+    for (const auto& s : current)
+    {
+        std::string prefix = "scenarios." + s.first + ".";
+        if (!base.HasNumber(prefix + "wallTime"))
+        {
+            std::cout << std::left << std::setw(24) << s.first << "not in the baseline"
+                      << std::endl;
+            continue;
+        }
+        for (const auto& metric : metrics)
+        {
+            double before = base.GetNumber(prefix + metric.name);
+            double now = s.second.*metric.value;
+            double change = before > 0 ? now / before - 1 : 0;
+            bool regressed = metric.higherIsBetter ? change < -metric.threshold
+                                                   : change > metric.threshold;
+            regressions += regressed;
+            std::cout << std::left << std::setw(24) << s.first << std::setw(18) << metric.name
+                      << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+                      << before << std::setw(14) << now << std::setw(9) << std::setprecision(1)
+                      << 100 * change << "%" << (regressed ? "  REGRESSION" : "") << std::endl;
+        }
+        if (base.GetNumber(prefix + "events") != s.second.events)
+        {
+            std::cout << std::left << std::setw(24) << s.first << "executed "
+                      << std::setprecision(0) << s.second.events << " events instead of "
+                      << base.GetNumber(prefix + "events") << ", the scenario changed"
+                      << std::endl;
+        }
+    }
+    if (regressions > 0)
+    {
+        std::cout << regressions << " metrics regressed beyond their threshold" << std::endl;
+        return 1;
+    }
+    std::cout << "No regression" << std::endl;
+    return 0;
+}
@@ -0,0 +1,1472 @@
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/netanim-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-epc-helper.h"
+#include "ns3/point-to-point-module.h"
+#include "adaptive-bearer-stats.h"
+#include "batched-bearer-activator.h"
+#include "bulk-install-helper.h"
+#include "cached-propagation-loss-model.h"
+#include "early-stop-controller.h"
+#include "full-buffer-source.h"
+#include "memory-accounting.h"
+#include "memory-pool.h"
+#include "mmap-trace-fading-loss-model.h"
+#include "pcap-ring-capture.h"
+#include "progress-scheduler.h"
+#include "recording-ff-mac-scheduler.h"
+#include "remote-host-pool.h"
+#include "rlc-buffer-monitor.h"
+#include "rlf-monitor.h"
+#include "rng-stream-allocator.h"
+#include "scenario-config.h"
+#include "shard-interference-exchange.h"
+#include "shm-metrics.h"
+#include "topk-a2a4-rsrq-handover-algorithm.h"
+#include "tti-calendar-scheduler.h"
+
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+/*
+ * LTE/EPC scenario driver. Every setting has a default, can be set in an INI
+ * file given with --config and overridden on the command line; the presets
+ * new-lte.ini, parta.ini, parta_old.ini and lte.ini reproduce the scenarios
+ * that used to be separate programs. Run with --PrintHelp for the settings.
+ *
+ * The eNBs sit on a square grid, the UEs around their eNB ("cell" layout) or
+ * on one disc around the centre of the grid ("disc" layout). The remote
+ * hosts, the X2 interfaces, the applications and the trace calculators are
+ * only installed when the configuration uses them. Nothing else is pruned:
+ * every UE and eNB gets the full LTE device, uplink included, and the
+ * internet stack, whatever the traffic.
+ *
+ * fullBufferDl saturates the downlink of every bearer, see FullBufferSource:
+ * the eNBs write UDP packets for the UEs straight to their PDCP, without
+ * remote hosts or S1-U tunnel, and the UE sinks count the throughput. The
+ * RLC SM entities of the LTE module are no option, as the LteHelper turns
+ * them back into RLC UM when there is an EPC.
+ *
+ * enableMemoryReport needs the heap hook of MemoryAccounting, which is only
+ * compiled in with -DMEMORY_ACCOUNTING (e.g. ./ns3 configure
+ * --cxxflags=-DMEMORY_ACCOUNTING), so that the other runs do not pay for it.
+ * memoryPool needs a build with -DMEMORY_POOL, which only replaces operator
+ * new/delete with the size class pool of MemoryPool, or -DMEMORY_ACCOUNTING.
+ *
+ * numShards > 1 splits the eNB grid into strips of rows, each simulated by a
+ * child process in its own directory shard<i>/ (output.txt holds its
+ * console output). The UEs of a cell stay in its shard, walking within the
+ * strip, and the downlink of the eNBs of the other shards within
+ * shardGhostDistance is replayed as interference one TTI late, see
+ * ShardInterferenceExchange. Handovers only happen within a shard, and the
+ * uplink interference from the other shards is not modelled. The shards
+ * wait for each other without limit until all finished their setup, then
+ * at most shardTimeout per TTI; a failed shard stops the others.
+ *
+ * schedulerLog records the CSCHED/SCHED requests of the MAC scheduler of
+ * every cell, see RecordingFfMacScheduler, for scheduler-replay to compare
+ * other schedulers on them offline.
+ *
+ * pathlossCacheDistance caches the pathloss of each link until one end has
+ * moved that far, see CachedPropagationLossModel. A cache lookup costs more
+ * than the default Friis model, so it is refused there: it only wraps a
+ * ns3::LteHelper::PathlossModel set in the [ns3] section to a costlier one.
+ *
+ * rlcBufferMonitor reports per cell the bytes queued in the downlink RLC
+ * buffers and those dropped on a full buffer, see RlcBufferMonitor; the
+ * buffer size is ns3::LteRlcUm::MaxTxBufferSize (and LteRlcAm), set in the
+ * [ns3] section.
+ */
+
+uint64_t ByteCounter = 0;    //!< Byte counter.
+uint64_t oldByteCounter = 0; //!< Old Byte counter,
+double RlcDelaySum = 0;      //!< Sum of the UE RLC PDU delays, in ns
+uint64_t RlcPduCount = 0;    //!< Number of UE RLC PDUs
+std::vector<uint64_t> CellDlBytes; //!< Bytes scheduled in the downlink, per eNB index
+
+/**
+ * UE Connection established notification.
+ *
+ * \param context The context.
+ * \param imsi The IMSI of the connected terminal.
+ * \param cellid The Cell ID.
+ * \param rnti The RNTI.
+ */
+void NotifyConnectionEstablishedUe(std::string context,
+                                   uint64_t imsi,
+                                   uint16_t cellid,
+                                   uint16_t rnti)
+{
+    std::cout << Simulator::Now().As(Time::S) << " " << context << " UE IMSI " << imsi
+              << ": connected to CellId " << cellid << " with RNTI " << rnti << std::endl;
+}
+
+/**
+ * UE Start Handover notification.
+ *
+ * \param context The context.
+ * \param imsi The IMSI of the connected terminal.
+ * \param cellid The actual Cell ID.
+ * \param rnti The RNTI.
+ * \param targetCellId The target Cell ID.
+ */
+void NotifyHandoverStartUe(std::string context,
+                           uint64_t imsi,
+                           uint16_t cellid,
+                           uint16_t rnti,
+                           uint16_t targetCellId)
+{
+    std::cout << Simulator::Now().As(Time::S) << " " << context << " UE IMSI " << imsi
+              << ": previously connected to CellId " << cellid << " with RNTI " << rnti
+              << ", doing handover to CellId " << targetCellId << std::endl;
+}
+
+/**
+ * UE Handover end successful notification.
+ *
+ * \param context The context.
+ * \param imsi The IMSI of the connected terminal.
+ * \param cellid The Cell ID.
+ * \param rnti The RNTI.
+ */
+void NotifyHandoverEndOkUe(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti)
+{
+    std::cout << Simulator::Now().As(Time::S) << " " << context << " UE IMSI " << imsi
+              << ": successful handover to CellId " << cellid << " with RNTI " << rnti << std::endl;
+}
+
+/**
+ * eNB Connection established notification.
+ *
+ * \param context The context.
+ * \param imsi The IMSI of the connected terminal.
+ * \param cellid The Cell ID.
+ * \param rnti The RNTI.
+ */
+void NotifyConnectionEstablishedEnb(std::string context,
+                                    uint64_t imsi,
+                                    uint16_t cellid,
+                                    uint16_t rnti)
+{
+    std::cout << Simulator::Now().As(Time::S) << " " << context << " eNB CellId " << cellid
+              << ": successful connection of UE with IMSI " << imsi << " RNTI " << rnti
+              << std::endl;
+}
+
+/**
+ * eNB Start Handover notification.
+ *
+ * \param context The context.
+ * \param imsi The IMSI of the connected terminal.
+ * \param cellid The actual Cell ID.
+ * \param rnti The RNTI.
+ * \param targetCellId The target Cell ID.
+ */
+void NotifyHandoverStartEnb(std::string context,
+                            uint64_t imsi,
+                            uint16_t cellid,
+                            uint16_t rnti,
+                            uint16_t targetCellId)
+{
+    std::cout << Simulator::Now().As(Time::S) << " " << context << " eNB CellId " << cellid
+              << ": start handover of UE with IMSI " << imsi << " RNTI " << rnti << " to CellId "
+              << targetCellId << std::endl;
+}
+
+/**
+ * eNB Handover end successful notification.
+ *
+ * \param context The context.
+ * \param imsi The IMSI of the connected terminal.
+ * \param cellid The Cell ID.
+ * \param rnti The RNTI.
+ */
+void NotifyHandoverEndOkEnb(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti)
+{
+    std::cout << Simulator::Now().As(Time::S) << " " << context << " eNB CellId " << cellid
+              << ": completed handover of UE with IMSI " << imsi << " RNTI " << rnti << std::endl;
+}
+
+/**
+ * Handover failure notification
+ *
+ * \param context The context.
+ * \param imsi The IMSI of the connected terminal.
+ * \param cellid The Cell ID.
+ * \param rnti The RNTI.
+ */
+void NotifyHandoverFailure(std::string context, uint64_t imsi, uint16_t cellid, uint16_t rnti)
+{
+    std::cout << Simulator::Now().As(Time::S) << " " << context << " eNB CellId " << cellid
+              << " IMSI " << imsi << " RNTI " << rnti << " handover failure" << std::endl;
+}
+
+/**
+ * Receive a packet.
+ *
+ * \param packet The packet.
+ */
+void ReceivePacket(Ptr<const Packet> packet, const Address &)
+{
+    ByteCounter += packet->GetSize();
+}
+
+/**
+ * Record the delay of an RLC PDU received by a UE.
+ *
+ * \param rnti The RNTI.
+ * \param lcid The logical channel id.
+ * \param bytes The PDU size.
+ * \param delay The RLC delay in nanoseconds.
+ */
+void RecordRlcDelay(uint16_t rnti, uint8_t lcid, uint32_t bytes, uint64_t delay)
+{
+    RlcDelaySum += delay;
+    RlcPduCount++;
+}
+
+/**
+ * A DRB was set up at a UE: connect a sink to the RxPDU trace of its RLC.
+ *
+ * \param sink The RxPDU sink.
+ * \param context The trace context, /NodeList/n/DeviceList/d/LteUeRrc/DrbCreated.
+ * \param imsi The IMSI.
+ * \param cellId The cell.
+ * \param rnti The RNTI.
+ * \param lcid The logical channel id.
+ */
+void ConnectRlcRxPdu(Callback<void, uint16_t, uint8_t, uint32_t, uint64_t> sink,
+                     std::string context,
+                     uint64_t imsi,
+                     uint16_t cellId,
+                     uint16_t rnti,
+                     uint8_t lcid)
+{
+    // DRB ids are the LCIDs minus the two SRBs
+    std::ostringstream path;
+    path << context.substr(0, context.rfind('/') + 1) << "DataRadioBearerMap/" << lcid - 2
+         << "/LteRlc/RxPDU";
+    Config::ConnectWithoutContext(path.str(), sink);
+}
+
+/**
+ * Count the bytes an eNB MAC scheduled in the downlink.
+ *
+ * \param enbIndex Index of the eNB.
+ * \param info The scheduling decision of one TTI for one UE.
+ */
+void RecordDlScheduling(uint32_t enbIndex, DlSchedulingCallbackInfo info)
+{
+    CellDlBytes[enbIndex] += info.sizeTb1 + info.sizeTb2;
+}
+
+/**
+ * Write the throughput to file.
+ *
+ * \param firstWrite True if first time writing.
+ * \param binSize Bin size.
+ * \param fileName Output filename.
+ */
+void Throughput(bool firstWrite, Time binSize, std::string fileName)
+{
+    std::ofstream output;
+
+    if (firstWrite)
+    {
+        output.open(fileName, std::ofstream::out);
+        firstWrite = false;
+    }
+    else
+    {
+        output.open(fileName, std::ofstream::app);
+    }
+
+    // Instantaneous throughput every bin
+
+    double throughput = (ByteCounter - oldByteCounter) * 8 / binSize.GetSeconds() / 1024 / 1024;
+    output << Simulator::Now().As(Time::S) << " " << throughput << std::endl;
+    oldByteCounter = ByteCounter;
+    Simulator::Schedule(binSize, &Throughput, firstWrite, binSize, fileName);
+}
+
+/**
+ * Function called when there is a course change
+ * \param context event context
+ * \param mobility a pointer to the mobility model
+ */
+static void
+CourseChange(std::string context, Ptr<const MobilityModel> mobility)
+{
+    Vector pos = mobility->GetPosition();
+    Vector vel = mobility->GetVelocity();
+    std::cout << Simulator::Now() << ", model=" << mobility << ", POS: x=" << pos.x
+              << ", y=" << pos.y << ", z=" << pos.z << "; VEL:" << vel.x << ", y=" << vel.y
+              << ", z=" << vel.z << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    // Simulation
+    Time simTime = Seconds(30);
+    std::string schedulerType = "ns3::TtiCalendarScheduler";
+    bool realtime = false;
+    bool enableEarlyStop = false;
+    double earlyStopPrecision = 0.02;
+    bool enableMemoryReport = false;
+    std::string memoryReportTimes = "1,10";
+    uint32_t installBatchSize = 1000;
+    bool memoryPool = false;
+    std::string logComponents = "";
+    Time progressInterval = Seconds(0);
+    std::string progressLog = "";
+    bool printConfig = false;
+    uint32_t numShards = 1;
+    int32_t shard = -1;
+    std::string shardShmName = "/lte-shards";
+    double shardGhostDistance = 10000;
+    Time shardTimeout = Seconds(60);
+    // Topology
+    uint32_t numEnbs = 4;
+    double interSiteDistance = 5000;
+    uint32_t numUes = 40;
+    uint32_t uesPerRemoteHost = 0;
+    Time sgiDelay = MilliSeconds(10);
+    uint32_t sgiMtu = 1500;
+    // Mobility
+    std::string ueLayout = "cell";
+    double ueDiscRadius = 500;
+    double ueSpeed = 0;
+    Time walkTime = Seconds(30);
+    std::string walkBounds = "";
+    bool logCourseChanges = false;
+    // Radio
+    uint16_t bandwidth = 50;
+    double enbTxPower = 40;
+    std::string macScheduler = "ns3::RrFfMacScheduler";
+    std::string schedulerLog = "";
+    bool useIdealRrc = true;
+    std::string handoverAlgorithm = "";
+    std::string ffrAlgorithm = "";
+    std::string fadingTraceFile = "";
+    double pathlossCacheDistance = 0;
+    Time pathlossCacheResolution = Seconds(0);
+    Time fadingWindow = Seconds(0.5);
+    // Traffic
+    bool dlTraffic = true;
+    bool ulTraffic = false;
+    bool fullBufferDl = false;
+    bool dedicatedBearer = true;
+    uint32_t packetSize = 1500;
+    Time packetInterval = MilliSeconds(1);
+    uint32_t maxPackets = 1000000;
+    double appStartMin = 0;
+    double appStartMax = 0.010;
+    Time appStopTime = Seconds(0);
+    std::string attachMode = "closest";
+    Time attachWindow = Seconds(0.1);
+    uint32_t attachBatchSize = 50;
+    // Traces
+    bool rlcTraces = true;
+    bool pdcpTraces = true;
+    bool phyTraces = true;
+    bool macTraces = true;
+    Time phyMacTracesStart = Seconds(0);
+    Time statsEpoch = Seconds(0.05);
+    bool adaptiveStatsEpoch = false;
+    Time statsMaxEpoch = Seconds(1.6);
+    bool throughputTrace = true;
+    Time throughputBin = Seconds(0.2);
+    bool handoverLog = false;
+    bool rlfMonitor = true;
+    bool rlcBufferMonitor = false;
+    std::string flowMonitorFile = "";
+    std::string animationFile = "";
+    uint32_t pcapRingSize = 0;
+    std::string pcapRingPrefix = "pcap-ring";
+    Time pcapRingPostTrigger = MilliSeconds(50);
+    double pcapRingThroughput = 0;
+    std::string pcapRingTriggerTimes = "";
+    std::string metricsShmName = "";
+    Time metricsInterval = MilliSeconds(100);
+
+    ScenarioConfig config(__FILE__);
+    config.Add("simTime", "Simulated time, an upper bound with the early stop", simTime);
+    config.Add("schedulerType", "Event scheduler TypeId", schedulerType);
+    config.Add("realtime", "Run in real time (RealtimeSimulatorImpl)", realtime);
+    config.Add("enableEarlyStop",
+               "Stop once the throughput and RLC delay confidence intervals are narrow enough",
+               enableEarlyStop);
+    config.Add("earlyStopPrecision",
+               "Target confidence interval half-width, relative to the mean",
+               earlyStopPrecision);
+    config.Add("enableMemoryReport",
+               "Print heap usage per layer and node role (build with -DMEMORY_ACCOUNTING)",
+               enableMemoryReport);
+    config.Add("memoryReportTimes",
+               "Comma separated times in seconds of the memory reports, plus one at the end",
+               memoryReportTimes);
+    config.Add("installBatchSize", "UEs installed per batch", installBatchSize);
+    config.Add("memoryPool",
+               "Serve small objects from recycled size classes, and skip their frees on teardown "
+               "(build with -DMEMORY_POOL)",
+               memoryPool);
+    config.Add("logComponents",
+               "Comma separated log components enabled at all levels",
+               logComponents);
+    config.Add("progressInterval",
+               "Wall-clock time between two progress reports, 0 for none",
+               progressInterval);
+    config.Add("progressLog", "File the progress reports are appended to", progressLog);
+    config.Add("printConfig", "Print the settings before running", printConfig);
+    config.Add("numShards", "Processes the eNB grid is split into, by rows", numShards);
+    config.Add("shard",
+               "Shard simulated by this process, -1 to fork one process per shard",
+               shard);
+    config.Add("shardShmName", "Shared memory segment of the shards", shardShmName);
+    config.Add("shardGhostDistance",
+               "Distance in m up to which eNBs of other shards interfere",
+               shardGhostDistance);
+    config.Add("shardTimeout",
+               "Wall-clock time a shard waits for another one, once all finished their setup",
+               shardTimeout);
+    config.Add("numEnbs", "Number of eNBs, on a square grid", numEnbs);
+    config.Add("interSiteDistance", "Distance between neighbour eNBs in meters", interSiteDistance);
+    config.Add("numUes", "Number of UEs", numUes);
+    config.Add("uesPerRemoteHost",
+               "UEs served by each remote host and SGi link, 0 for a single remote host",
+               uesPerRemoteHost);
+    config.Add("sgiDelay", "Delay of the SGi links", sgiDelay);
+    config.Add("sgiMtu",
+               "MTU of the SGi links, 1600 to carry 1500 byte UDP payloads unfragmented",
+               sgiMtu);
+    config.Add("ueLayout",
+               "cell: UEs in equal groups on a disc around each eNB, "
+               "disc: UEs on one disc around the centre of the grid",
+               ueLayout);
+    config.Add("ueDiscRadius", "Radius of the UE discs in meters", ueDiscRadius);
+    config.Add("ueSpeed", "UE speed in m/s, 0 for static UEs, else a 2D random walk", ueSpeed);
+    config.Add("walkTime", "Time between random walk direction changes", walkTime);
+    config.Add("walkBounds",
+               "Random walk bounds xmin|xmax|ymin|ymax, empty for the grid plus 500 m",
+               walkBounds);
+    config.Add("logCourseChanges", "Print the UE course changes", logCourseChanges);
+    config.Add("bandwidth", "DL and UL bandwidth in RBs", bandwidth);
+    config.Add("enbTxPower", "eNB transmission power in dBm", enbTxPower);
+    config.Add("macScheduler", "FF MAC scheduler TypeId", macScheduler);
+    config.Add("schedulerLog",
+               "Prefix of the per cell scheduler input logs for scheduler-replay, empty for none",
+               schedulerLog);
+    config.Add("useIdealRrc", "Ideal RRC instead of the real RRC protocol", useIdealRrc);
+    config.Add("handoverAlgorithm",
+               "Handover algorithm TypeId, empty for no handover (and no X2)",
+               handoverAlgorithm);
+    config.Add("ffrAlgorithm", "FFR algorithm TypeId, empty for none", ffrAlgorithm);
+    config.Add("fadingTraceFile",
+               "Binary fading trace from fading-trace-convert, empty to disable fading",
+               fadingTraceFile);
+    config.Add("fadingWindow", "Fading trace window per link", fadingWindow);
+    config.Add("pathlossCacheDistance",
+               "Distance in m a UE moves before its pathloss is recomputed, 0 for no cache; "
+               "only for a ns3::LteHelper::PathlossModel other than Friis",
+               pathlossCacheDistance);
+    config.Add("pathlossCacheResolution",
+               "Time between two reads of a UE position by the pathloss cache, 0 on every use",
+               pathlossCacheResolution);
+    config.Add("dlTraffic", "UDP downlink flow from a remote host to each UE", dlTraffic);
+    config.Add("ulTraffic", "UDP uplink flow from each UE to a remote host", ulTraffic);
+    config.Add("fullBufferDl",
+               "Saturated downlink written to the eNB PDCP instead of UDP flows from remote hosts",
+               fullBufferDl);
+    config.Add("dedicatedBearer",
+               "Carry each UE's flows on a dedicated bearer instead of the default one",
+               dedicatedBearer);
+    config.Add("packetSize", "UDP payload size in bytes", packetSize);
+    config.Add("packetInterval", "Interval between UDP packets", packetInterval);
+    config.Add("maxPackets", "Packets sent per UDP flow", maxPackets);
+    config.Add("appStartMin", "Earliest application start after attach, in seconds", appStartMin);
+    config.Add("appStartMax", "Latest application start after attach, in seconds", appStartMax);
+    config.Add("appStopTime", "Time the UDP clients stop, 0 to never stop", appStopTime);
+    config.Add("attachMode",
+               "closest: closest eNB, cell: the eNB of the UE's group, idle: cell selection",
+               attachMode);
+    config.Add("attachWindow", "Window over which the UE attaches are spread", attachWindow);
+    config.Add("attachBatchSize", "UEs attached together", attachBatchSize);
+    config.Add("rlcTraces", "Write the RLC statistics", rlcTraces);
+    config.Add("pdcpTraces", "Write the PDCP statistics", pdcpTraces);
+    config.Add("phyTraces", "Write the PHY statistics", phyTraces);
+    config.Add("macTraces", "Write the MAC statistics", macTraces);
+    config.Add("phyMacTracesStart",
+               "Time the PHY/MAC statistics start, 0 to include the attach",
+               phyMacTracesStart);
+    config.Add("statsEpoch",
+               "Epoch of the RLC/PDCP statistics, the shortest one if adaptive",
+               statsEpoch);
+    config.Add("adaptiveStatsEpoch",
+               "Per bearer RLC/PDCP epochs, coarsened while the bearer is steady",
+               adaptiveStatsEpoch);
+    config.Add("statsMaxEpoch", "Longest adaptive RLC/PDCP epoch", statsMaxEpoch);
+    config.Add("throughputTrace",
+               "Write the downlink throughput to rlf_dl_thrput_*",
+               throughputTrace);
+    config.Add("throughputBin", "Bin of the downlink throughput trace", throughputBin);
+    config.Add("handoverLog", "Print the connection and handover events", handoverLog);
+    config.Add("rlfMonitor",
+               "Count the radio link failures and outages of each cell",
+               rlfMonitor);
+    config.Add("rlcBufferMonitor",
+               "Report the occupancy and drops of the downlink RLC buffers of each cell",
+               rlcBufferMonitor);
+    config.Add("flowMonitorFile",
+               "Flow monitor XML output, empty for no flow monitor",
+               flowMonitorFile);
+    config.Add("animationFile", "NetAnim XML output, empty for no animation", animationFile);
+    config.Add("pcapRingSize",
+               "MB of packets kept in memory per SGi and S1-U link for triggered pcap dumps, 0 "
+               "for none",
+               pcapRingSize);
+    config.Add("pcapRingPrefix", "Prefix of the triggered pcap dumps", pcapRingPrefix);
+    config.Add("pcapRingPostTrigger",
+               "Capture time after a trigger before the dump",
+               pcapRingPostTrigger);
+    config.Add("pcapRingThroughput",
+               "Dump when a link direction falls below this many Mb/s per throughputBin, 0 for "
+               "never",
+               pcapRingThroughput);
+    config.Add("pcapRingTriggerTimes",
+               "Comma separated times in seconds of extra dumps",
+               pcapRingTriggerTimes);
+    config.Add("metricsShmName",
+               "Shared memory segment for lte-metrics-reader, empty to publish no live metrics",
+               metricsShmName);
+    config.Add("metricsInterval",
+               "Simulation time between two live metric snapshots",
+               metricsInterval);
+    config.Parse(argc, argv);
+    NS_ABORT_MSG_IF(enableMemoryReport && !MemoryAccounting::HOOKED,
+                    "enableMemoryReport needs a build with -DMEMORY_ACCOUNTING");
+    NS_ABORT_MSG_IF(memoryPool && !MemoryPool::HOOKED,
+                    "memoryPool needs a build with -DMEMORY_POOL or -DMEMORY_ACCOUNTING");
+    if (memoryPool)
+    {
+        MemoryPool::Enable();
+    }
+
+    NS_ABORT_MSG_IF(numEnbs == 0 || numUes == 0, "At least one eNB and one UE are needed");
+    NS_ABORT_MSG_IF(ueLayout != "cell" && ueLayout != "disc", "Unknown UE layout " << ueLayout);
+    NS_ABORT_MSG_IF(attachMode != "closest" && attachMode != "cell" && attachMode != "idle",
+                    "Unknown attach mode " << attachMode);
+    NS_ABORT_MSG_IF(numShards > 1 && ueLayout != "cell", "Shards need ueLayout=cell");
+    NS_ABORT_MSG_IF(numShards > 1 && enableEarlyStop, "All the shards must run until simTime");
+    if (printConfig)
+    {
+        config.Print(std::cout);
+    }
+
+    // Sharded run: this process only launches the shards and waits for them
+    if (numShards > 1 && shard < 0)
+    {
+        if (!handoverAlgorithm.empty())
+        {
+            std::cerr << "Warning: with numShards > 1 the UEs are only handed over within their "
+                         "shard, there is no X2 between the shards"
+                      << std::endl;
+        }
+        ShardInterferenceExchange::CreateSegment(shardShmName, numShards, numEnbs, bandwidth);
+        std::vector<pid_t> children;
+        for (uint32_t s = 0; s < numShards && shard < 0; s++)
+        {
+            pid_t pid = fork();
+            NS_ABORT_MSG_IF(pid < 0, "Cannot fork shard " << s);
+            if (pid == 0)
+            {
+                shard = s;
+            }
+            else
+            {
+                children.push_back(pid);
+            }
+        }
+        if (shard < 0)
+        {
+            // A failed shard stops the others, which would wait for it forever
+            // in the startup barrier of ShardInterferenceExchange
+            uint32_t failed = 0;
+            for (std::size_t n = 0; n < children.size(); n++)
+            {
+                int status = 0;
+                pid_t pid = wait(&status);
+                if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+                {
+                    continue;
+                }
+                failed++;
+                for (pid_t& child : children)
+                {
+                    if (child == pid)
+                    {
+                        child = -1;
+                    }
+                    else if (child > 0 && failed == 1)
+                    {
+                        kill(child, SIGTERM);
+                    }
+                }
+            }
+            shm_unlink(shardShmName.c_str());
+            std::cout << numShards - failed << " of " << numShards
+                      << " shards completed, outputs in shard*/" << std::endl;
+            return failed > 0 ? 1 : 0;
+        }
+    }
+    NS_ABORT_MSG_IF(shard >= static_cast<int32_t>(numShards), "Shard " << shard << " out of range");
+    if (numShards > 1)
+    {
+        std::string dir = "shard" + std::to_string(shard);
+        NS_ABORT_MSG_IF(mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST, "Cannot create " << dir);
+        NS_ABORT_MSG_IF(chdir(dir.c_str()) != 0, "Cannot enter " << dir);
+        NS_ABORT_MSG_IF(!std::freopen("output.txt", "w", stdout), "Cannot write " << dir);
+        if (!metricsShmName.empty())
+        {
+            metricsShmName += "-" + dir;
+        }
+    }
+
+    // The eNB grid, and the rows of it simulated here: eNBs [enbBegin, enbEnd)
+    // and the UEs of their cells, [ueBegin, ueEnd)
+    uint32_t gridColumns = static_cast<uint32_t>(std::ceil(std::sqrt(numEnbs)));
+    uint32_t gridRows = (numEnbs + gridColumns - 1) / gridColumns;
+    NS_ABORT_MSG_IF(numShards > gridRows, "More shards than eNB rows");
+    auto shardRowBegin = [gridRows, numShards](uint32_t s) { return s * gridRows / numShards; };
+    auto shardOf = [&shardRowBegin, gridColumns, numShards](uint32_t enbIndex) {
+        uint32_t s = 0;
+        while (s + 1 < numShards && enbIndex / gridColumns >= shardRowBegin(s + 1))
+        {
+            s++;
+        }
+        return s;
+    };
+    auto enbPosition = [gridColumns, interSiteDistance](uint32_t enbIndex) {
+        return Vector((enbIndex % gridColumns) * interSiteDistance,
+                      (enbIndex / gridColumns) * interSiteDistance,
+                      0.0);
+    };
+    uint32_t thisShard = numShards > 1 ? shard : 0;
+    uint32_t rowBegin = shardRowBegin(thisShard);
+    uint32_t rowEnd = shardRowBegin(thisShard + 1);
+    uint32_t enbBegin = rowBegin * gridColumns;
+    uint32_t enbEnd = std::min(rowEnd * gridColumns, numEnbs);
+    auto firstUeOf = [numEnbs, numUes](uint32_t enbIndex) {
+        return static_cast<uint32_t>(
+            (static_cast<uint64_t>(enbIndex) * numUes + numEnbs - 1) / numEnbs);
+    };
+    uint32_t ueBegin = firstUeOf(enbBegin);
+    uint32_t ueEnd = firstUeOf(enbEnd);
+    NS_ABORT_MSG_IF(ueEnd == ueBegin, "No UE in shard " << thisShard);
+
+    SetupPhaseTimer setupTimer;
+    setupTimer.Start("EPC and remote host");
+
+    if (realtime)
+    {
+        GlobalValue::Bind("SimulatorImplementationType",
+                          StringValue("ns3::RealtimeSimulatorImpl"));
+    }
+    if (progressInterval.IsStrictlyPositive())
+    {
+        // Wraps the event scheduler, reading the wall clock between events
+        Config::SetDefault("ns3::ProgressScheduler::Scheduler", StringValue(schedulerType));
+        Config::SetDefault("ns3::ProgressScheduler::Interval", TimeValue(progressInterval));
+        Config::SetDefault("ns3::ProgressScheduler::StopTime", TimeValue(simTime));
+        Config::SetDefault("ns3::ProgressScheduler::LogFile", StringValue(progressLog));
+        schedulerType = "ns3::ProgressScheduler";
+    }
+    GlobalValue::Bind("SchedulerType", StringValue(schedulerType));
+
+    Config::SetDefault("ns3::LteEnbPhy::TxPower", DoubleValue(enbTxPower));
+
+    // Enable Logging
+    auto logLevel = (LogLevel)(LOG_PREFIX_FUNC | LOG_PREFIX_TIME | LOG_LEVEL_ALL);
+    for (const auto& component : ScenarioConfig::Split(logComponents))
+    {
+        LogComponentEnable(component.c_str(), logLevel);
+    }
+
+    // Generating LTE Helper and adding epcHelper to it
+    Ptr<LteHelper> lteHelper = CreateObject<LteHelper>();
+    Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper>();
+    lteHelper->SetEpcHelper(epcHelper);
+    lteHelper->SetAttribute("UseIdealRrc", BooleanValue(useIdealRrc));
+
+    // PGateway from epcHelper
+    Ptr<Node> pgw = epcHelper->GetPgwNode();
+
+    // Remote hosts, each with its own link to the PGW, only when they have
+    // flows to serve
+    bool udpTraffic = !fullBufferDl && (dlTraffic || ulTraffic);
+    uint32_t numRemoteHosts = 0;
+    if (udpTraffic)
+    {
+        numRemoteHosts =
+            uesPerRemoteHost == 0 ? 1 : (ueEnd - ueBegin + uesPerRemoteHost - 1) / uesPerRemoteHost;
+    }
+    std::unique_ptr<RemoteHostPool> remoteHosts;
+    if (numRemoteHosts > 0)
+    {
+        remoteHosts = std::make_unique<RemoteHostPool>(pgw, numRemoteHosts);
+        PointToPointHelper p2ph;
+        p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Gb/s")));
+        // 1500 byte UDP payloads make 1528 byte IP packets: an MTU above that keeps
+        // them from being fragmented, and tunnelled twice as often, on S5/S1-U
+        p2ph.SetDeviceAttribute("Mtu", UintegerValue(sgiMtu));
+        p2ph.SetChannelAttribute("Delay", TimeValue(sgiDelay));
+        // Routing Internet towards LTE n/w
+        remoteHosts->Install(p2ph, Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"));
+    }
+
+    // Create Nodes: eNodeB and UE
+    setupTimer.Start("nodes and mobility");
+    NodeContainer enbNodes;
+    NodeContainer ueNodes;
+    enbNodes.Create(enbEnd - enbBegin);
+    ueNodes.Create(ueEnd - ueBegin);
+
+    // Mobility model for enb: a square grid
+    Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator>();
+    for (uint32_t i = enbBegin; i < enbEnd; i++)
+    {
+        enbPositionAlloc->Add(enbPosition(i));
+    }
+    MobilityHelper enbMobility;
+    enbMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    enbMobility.SetPositionAllocator(enbPositionAlloc);
+    enbMobility.Install(enbNodes);
+
+    // Random streams are keyed by UE index, so that UE u keeps its position,
+    // channel and start time whatever the number of UEs, and of shards
+    RngStreamAllocator rngStreams;
+    auto ueStream = [&rngStreams, ueBegin](uint32_t u, RngStreamAllocator::Component c) {
+        return rngStreams.GetStream(RngStreamAllocator::UE, ueBegin + u, c);
+    };
+    auto enbStream = [&rngStreams, enbBegin](uint32_t i, RngStreamAllocator::Component c) {
+        return rngStreams.GetStream(RngStreamAllocator::ENB, enbBegin + i, c);
+    };
+
+    // eNB of the group of a UE in the cell layout and the cell attach mode,
+    // both indices local to this shard
+    auto enbIndexOf = [numEnbs, numUes, ueBegin, enbBegin](uint32_t u) {
+        return static_cast<uint32_t>(static_cast<uint64_t>(ueBegin + u) * numEnbs / numUes) -
+               enbBegin;
+    };
+
+    // Mobility model for ue
+    std::vector<Ptr<UniformDiscPositionAllocator>> uePositionAllocs;
+    if (ueLayout == "cell")
+    {
+        for (uint32_t i = 0; i < enbNodes.GetN(); i++)
+        {
+            Vector enbPosition = enbNodes.Get(i)->GetObject<MobilityModel>()->GetPosition();
+            Ptr<UniformDiscPositionAllocator> alloc = CreateObject<UniformDiscPositionAllocator>();
+            alloc->SetX(enbPosition.x);
+            alloc->SetY(enbPosition.y);
+            alloc->SetRho(ueDiscRadius);
+            uePositionAllocs.push_back(alloc);
+        }
+    }
+    else
+    {
+        Ptr<UniformDiscPositionAllocator> alloc = CreateObject<UniformDiscPositionAllocator>();
+        alloc->SetX((gridColumns - 1) * interSiteDistance / 2);
+        alloc->SetY((gridRows - 1) * interSiteDistance / 2);
+        alloc->SetRho(ueDiscRadius);
+        uePositionAllocs.push_back(alloc);
+    }
+    if (walkBounds.empty())
+    {
+        std::ostringstream oss;
+        oss << -500.0 << "|" << (gridColumns - 1) * interSiteDistance + 500 << "|"
+            << rowBegin * interSiteDistance - 500 << "|"
+            << (rowEnd - 1) * interSiteDistance + 500;
+        walkBounds = oss.str();
+    }
+    for (uint32_t u = 0; u < ueNodes.GetN(); u++)
+    {
+        Ptr<UniformDiscPositionAllocator> alloc =
+            uePositionAllocs[ueLayout == "cell" ? enbIndexOf(u) : 0];
+        alloc->AssignStreams(ueStream(u, RngStreamAllocator::POSITION));
+        MobilityHelper ueMobility;
+        ueMobility.SetPositionAllocator(alloc);
+        if (ueSpeed > 0)
+        {
+            std::ostringstream speed;
+            speed << "ns3::ConstantRandomVariable[Constant=" << ueSpeed << "]";
+            ueMobility.SetMobilityModel("ns3::RandomWalk2dMobilityModel",
+                                        "Mode",
+                                        StringValue("Time"),
+                                        "Time",
+                                        TimeValue(walkTime),
+                                        "Speed",
+                                        StringValue(speed.str()),
+                                        "Bounds",
+                                        StringValue(walkBounds));
+        }
+        else
+        {
+            ueMobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        }
+        ueMobility.Install(ueNodes.Get(u));
+        MobilityHelper::AssignStreams(NodeContainer(ueNodes.Get(u)),
+                                      ueStream(u, RngStreamAllocator::MOBILITY));
+    }
+
+    // Create Devices and install them in nodes enb and ue
+    NetDeviceContainer enbDevs;
+    NetDeviceContainer ueDevs;
+    if (schedulerLog.empty())
+    {
+        lteHelper->SetSchedulerType(macScheduler);
+        lteHelper->SetSchedulerAttribute("HarqEnabled", BooleanValue(true));
+    }
+    else
+    {
+        // The recorder creates macScheduler itself, from its defaults
+        Config::SetDefault("ns3::RecordingFfMacScheduler::Scheduler", StringValue(macScheduler));
+        Config::SetDefault(macScheduler + "::HarqEnabled", BooleanValue(true));
+        lteHelper->SetSchedulerType("ns3::RecordingFfMacScheduler");
+    }
+
+    lteHelper->SetEnbDeviceAttribute("DlBandwidth", UintegerValue(bandwidth));
+    lteHelper->SetEnbDeviceAttribute("UlBandwidth", UintegerValue(bandwidth));
+
+    // Fading trace shared read-only between all processes using the same file
+    if (!fadingTraceFile.empty())
+    {
+        lteHelper->SetFadingModel("ns3::MmapTraceFadingLossModel");
+        lteHelper->SetFadingModelAttribute("TraceFilename", StringValue(fadingTraceFile));
+        lteHelper->SetFadingModelAttribute("WindowSize", TimeValue(fadingWindow));
+    }
+
+    if (pathlossCacheDistance > 0)
+    {
+        // Wraps the model set in [ns3], the helper passes it the frequency
+        TypeId::AttributeInformation info;
+        LteHelper::GetTypeId().LookupAttributeByName("PathlossModel", &info);
+        TypeId pathlossModel = DynamicCast<const TypeIdValue>(info.initialValue)->Get();
+        lteHelper->SetPathlossModelType(CachedPropagationLossModel::GetTypeId());
+        lteHelper->SetPathlossModelAttribute("Model", StringValue(pathlossModel.GetName()));
+        lteHelper->SetPathlossModelAttribute("DistanceThreshold",
+                                             DoubleValue(pathlossCacheDistance));
+        lteHelper->SetPathlossModelAttribute("PositionResolution",
+                                             TimeValue(pathlossCacheResolution));
+    }
+
+    // Handover and FFR algorithms, configured through [ns3] attribute defaults
+    if (!handoverAlgorithm.empty())
+    {
+        lteHelper->SetHandoverAlgorithmType(handoverAlgorithm);
+    }
+    if (!ffrAlgorithm.empty())
+    {
+        lteHelper->SetFfrAlgorithmType(ffrAlgorithm);
+    }
+
+    // Install node by node so that the memory report can charge each node
+    setupTimer.Start("eNB devices");
+    for (uint32_t i = 0; i < enbNodes.GetN(); ++i)
+    {
+        MemoryAccounting::Scope scope("LteEnbNetDevice", enbNodes.Get(i)->GetId());
+        enbDevs.Add(lteHelper->InstallEnbDevice(enbNodes.Get(i)));
+    }
+
+    // One scheduler input log per cell: <schedulerLog>_<cell id>.bin
+    std::vector<Ptr<RecordingFfMacScheduler>> schedulerRecorders;
+    if (!schedulerLog.empty())
+    {
+        for (uint32_t i = 0; i < enbDevs.GetN(); ++i)
+        {
+            Ptr<LteEnbNetDevice> enb = enbDevs.Get(i)->GetObject<LteEnbNetDevice>();
+            for (const auto& cc : enb->GetCcMap())
+            {
+                Ptr<ComponentCarrierEnb> carrier = DynamicCast<ComponentCarrierEnb>(cc.second);
+                Ptr<RecordingFfMacScheduler> recorder =
+                    DynamicCast<RecordingFfMacScheduler>(carrier->GetFfMacScheduler());
+                uint16_t cellId = carrier->GetCellId();
+                recorder->Open(schedulerLog + "_" + std::to_string(cellId) + ".bin", cellId);
+                schedulerRecorders.push_back(recorder);
+            }
+        }
+    }
+
+    // X2 Interface, only used by handovers
+    if (!handoverAlgorithm.empty())
+    {
+        setupTimer.Start("X2 interfaces");
+        lteHelper->AddX2Interface(enbNodes);
+    }
+
+    // Downlink interference exchanged with the other shards
+    std::unique_ptr<ShardInterferenceExchange> shardExchange;
+    if (numShards > 1)
+    {
+        setupTimer.Start("shard ghosts");
+        shardExchange = std::make_unique<ShardInterferenceExchange>(shardShmName, thisShard);
+        shardExchange->SetTimeout(shardTimeout);
+        // Only the rows within shardGhostDistance can hold a close eNB, and
+        // the closest eNB of a row is the one of the same column, or the last
+        // one of a partial row
+        uint32_t reach = gridRows;
+        if (interSiteDistance > 0)
+        {
+            reach = static_cast<uint32_t>(std::min<double>(gridRows,
+                                                           shardGhostDistance / interSiteDistance));
+        }
+        auto closeToShard = [&](uint32_t enbIndex, uint32_t s) {
+            uint32_t row = enbIndex / gridColumns;
+            uint32_t column = enbIndex % gridColumns;
+            uint32_t first = std::max(shardRowBegin(s), row > reach ? row - reach : 0);
+            uint32_t last = std::min(shardRowBegin(s + 1), row + reach + 1);
+            for (uint32_t r = first; r < last; r++)
+            {
+                uint32_t rowEnbs = std::min(gridColumns, numEnbs - r * gridColumns);
+                uint32_t j = r * gridColumns + std::min(column, rowEnbs - 1);
+                if (CalculateDistance(enbPosition(enbIndex), enbPosition(j)) <= shardGhostDistance)
+                {
+                    return true;
+                }
+            }
+            return false;
+        };
+        for (uint32_t j = 0; j < numEnbs; j++)
+        {
+            uint32_t owner = shardOf(j);
+            if (owner != thisShard && closeToShard(j, thisShard))
+            {
+                shardExchange->AddGhostEnb(j, owner, enbPosition(j));
+            }
+        }
+        for (uint32_t i = 0; i < enbDevs.GetN(); i++)
+        {
+            for (uint32_t s = 0; s < numShards; s++)
+            {
+                if (s != thisShard && closeToShard(enbBegin + i, s))
+                {
+                    shardExchange->AddBorderEnb(enbBegin + i,
+                                                enbDevs.Get(i)->GetObject<LteEnbNetDevice>());
+                    break;
+                }
+            }
+        }
+        Ptr<LteEnbNetDevice> enb = enbDevs.Get(0)->GetObject<LteEnbNetDevice>();
+        shardExchange->Start(
+            lteHelper->GetDownlinkSpectrumChannel(),
+            LteSpectrumValueHelper::GetSpectrumModel(enb->GetDlEarfcn(), enb->GetDlBandwidth()));
+    }
+
+    // LTE device, IP stack, address and default route of the UEs, in batches.
+    // The EPC needs the UE IPv4 stack to activate the default bearer, even
+    // without traffic.
+    LteBulkUeInstaller ueInstaller(lteHelper, epcHelper, installBatchSize);
+    ueInstaller.SetTimer(&setupTimer);
+    ueInstaller.SetNodeWrapper(
+        [](Ptr<Node> node, const std::string& layer, std::function<void()> step) {
+            MemoryAccounting::Scope scope(layer, node->GetId());
+            step();
+        });
+    ueInstaller.Install(ueNodes);
+    ueDevs = ueInstaller.GetUeDevices();
+    Ipv4InterfaceContainer ueIpIfaces = ueInstaller.GetUeIpv4Interfaces();
+
+    // Per eNB and per UE streams, then the shared channel and EPC models last,
+    // as every LteHelper::AssignStreams() call also reassigns the EPC streams
+    setupTimer.Start("random streams");
+    InternetStackHelper internet;
+    for (uint32_t i = 0; i < enbDevs.GetN(); i++)
+    {
+        rngStreams.CheckUsed(
+            lteHelper->AssignStreams(NetDeviceContainer(enbDevs.Get(i)),
+                                     enbStream(i, RngStreamAllocator::LTE_DEVICE)));
+    }
+    for (uint32_t u = 0; u < ueDevs.GetN(); u++)
+    {
+        rngStreams.CheckUsed(lteHelper->AssignStreams(NetDeviceContainer(ueDevs.Get(u)),
+                                                      ueStream(u, RngStreamAllocator::LTE_DEVICE)));
+        rngStreams.CheckUsed(internet.AssignStreams(NodeContainer(ueNodes.Get(u)),
+                                                    ueStream(u, RngStreamAllocator::INTERNET)));
+    }
+    int64_t channelStream =
+        rngStreams.GetStream(RngStreamAllocator::GLOBAL, 0, RngStreamAllocator::CHANNEL);
+    Ptr<SpectrumChannel> dlChannel = lteHelper->GetDownlinkSpectrumChannel();
+    Ptr<SpectrumChannel> ulChannel = lteHelper->GetUplinkSpectrumChannel();
+    channelStream += dlChannel->GetPropagationLossModel()->AssignStreams(channelStream);
+    channelStream += ulChannel->GetPropagationLossModel()->AssignStreams(channelStream);
+    if (dlChannel->GetSpectrumPropagationLossModel())
+    {
+        // The fading model is shared by both channels
+        dlChannel->GetSpectrumPropagationLossModel()->AssignStreams(channelStream);
+    }
+    if (remoteHosts)
+    {
+        internet.AssignStreams(
+            remoteHosts->GetNodes(),
+            rngStreams.GetStream(RngStreamAllocator::GLOBAL, 0, RngStreamAllocator::INTERNET));
+    }
+    lteHelper->AssignStreams(
+        NetDeviceContainer(),
+        rngStreams.GetStream(RngStreamAllocator::GLOBAL, 0, RngStreamAllocator::EPC));
+
+    // Ports of the flows of UE u: dlPort + u + 1 and ulPort + u + 1
+    const uint16_t dlPort = 10000;
+    const uint16_t ulPort = 20000;
+
+    // Attach the UEs, with their dedicated bearer set up in the initial
+    // context of the attach
+    setupTimer.Start("bearers and attach");
+    BatchedBearerActivator bearerActivator(lteHelper);
+    bearerActivator.SetAttachSpread(attachWindow, attachBatchSize);
+    if (udpTraffic && dedicatedBearer)
+    {
+        bearerActivator.SetDedicatedBearers(
+            EpsBearer(EpsBearer::NGBR_VIDEO_TCP_DEFAULT),
+            1,
+            [dlTraffic, ulTraffic, dlPort, ulPort](uint32_t ueIndex, uint32_t /* bearerIndex */) {
+                Ptr<EpcTft> tft = Create<EpcTft>();
+                if (dlTraffic)
+                {
+                    EpcTft::PacketFilter dlpf;
+                    dlpf.localPortStart = dlPort + ueIndex + 1;
+                    dlpf.localPortEnd = dlPort + ueIndex + 1;
+                    tft->Add(dlpf);
+                }
+                if (ulTraffic)
+                {
+                    EpcTft::PacketFilter ulpf;
+                    ulpf.remotePortStart = ulPort + ueIndex + 1;
+                    ulpf.remotePortEnd = ulPort + ueIndex + 1;
+                    tft->Add(ulpf);
+                }
+                return tft;
+            });
+    }
+    if (attachMode == "closest")
+    {
+        bearerActivator.AttachToClosestEnb(ueDevs, enbDevs);
+    }
+    else if (attachMode == "cell")
+    {
+        bearerActivator.AttachToEnb(ueDevs, enbDevs, enbIndexOf);
+    }
+    else
+    {
+        bearerActivator.Attach(ueDevs);
+    }
+
+    // randomize a bit start times to avoid simulation artifacts
+    // (e.g., buffer overflows due to packet transmissions happening
+    // exactly at the same time)
+    Ptr<UniformRandomVariable> startTimeSeconds = CreateObject<UniformRandomVariable>();
+    startTimeSeconds->SetAttribute("Min", DoubleValue(appStartMin));
+    startTimeSeconds->SetAttribute("Max", DoubleValue(appStartMax));
+
+    // In full-buffer mode the eNBs write the packets of the UEs to their
+    // bearers, and the UEs only need a sink
+    setupTimer.Start("applications");
+    FullBufferSource fullBuffer(packetSize);
+    if (fullBufferDl)
+    {
+        for (uint32_t u = 0; u < ueNodes.GetN(); ++u)
+        {
+            PacketSinkHelper dlPacketSinkHelper(
+                "ns3::UdpSocketFactory",
+                InetSocketAddress(Ipv4Address::GetAny(), dlPort + u + 1));
+            ApplicationContainer dlSink = dlPacketSinkHelper.Install(ueNodes.Get(u));
+            dlSink.Get(0)->TraceConnectWithoutContext("Rx", MakeCallback(&ReceivePacket));
+            fullBuffer.AddUe(ueDevs.Get(u)->GetObject<LteUeNetDevice>()->GetImsi(),
+                             ueIpIfaces.GetAddress(u),
+                             dlPort + u + 1);
+        }
+        fullBuffer.Install(enbDevs, epcHelper->GetUeDefaultGatewayAddress());
+    }
+    uint32_t numAppUes = udpTraffic ? ueNodes.GetN() : 0;
+    for (uint32_t u = 0; u < numAppUes; ++u)
+    {
+        Ptr<Node> ue = ueNodes.Get(u);
+        Ptr<Node> remoteHost = remoteHosts->GetHostForUe(u);
+        startTimeSeconds->SetStream(ueStream(u, RngStreamAllocator::APPLICATION));
+
+        ApplicationContainer clientApps;
+        ApplicationContainer serverApps;
+
+        if (dlTraffic)
+        {
+            UdpClientHelper dlClientHelper(ueIpIfaces.GetAddress(u), dlPort + u + 1);
+            dlClientHelper.SetAttribute("MaxPackets", UintegerValue(maxPackets));
+            dlClientHelper.SetAttribute("Interval", TimeValue(packetInterval));
+            dlClientHelper.SetAttribute("PacketSize", UintegerValue(packetSize));
+            clientApps.Add(dlClientHelper.Install(remoteHost));
+            PacketSinkHelper dlPacketSinkHelper(
+                "ns3::UdpSocketFactory",
+                InetSocketAddress(Ipv4Address::GetAny(), dlPort + u + 1));
+            ApplicationContainer dlSink = dlPacketSinkHelper.Install(ue);
+            dlSink.Get(0)->TraceConnectWithoutContext("Rx", MakeCallback(&ReceivePacket));
+            serverApps.Add(dlSink);
+        }
+
+        if (ulTraffic)
+        {
+            UdpClientHelper ulClientHelper(remoteHosts->GetAddressForUe(u), ulPort + u + 1);
+            ulClientHelper.SetAttribute("MaxPackets", UintegerValue(maxPackets));
+            ulClientHelper.SetAttribute("Interval", TimeValue(packetInterval));
+            ulClientHelper.SetAttribute("PacketSize", UintegerValue(packetSize));
+            clientApps.Add(ulClientHelper.Install(ue));
+            PacketSinkHelper ulPacketSinkHelper(
+                "ns3::UdpSocketFactory",
+                InetSocketAddress(Ipv4Address::GetAny(), ulPort + u + 1));
+            serverApps.Add(ulPacketSinkHelper.Install(remoteHost));
+        }
+
+        Time startTime = bearerActivator.GetAttachTime(u) + Seconds(startTimeSeconds->GetValue());
+        serverApps.Start(startTime);
+        clientApps.Start(startTime);
+        if (appStopTime.IsStrictlyPositive())
+        {
+            clientApps.Stop(appStopTime);
+        }
+    }
+
+    // RLC/PDCP statistics must be connected before the bearers are created,
+    // the PHY/MAC calculators are only created once their output is needed
+    setupTimer.Start("traces");
+    std::vector<Ptr<AdaptiveBearerStatsCalculator>> adaptiveStats;
+    {
+        MemoryAccounting::Scope scope("Trace calculators");
+        if (rlcTraces && !adaptiveStatsEpoch)
+        {
+            lteHelper->EnableRlcTraces();
+            lteHelper->GetRlcStats()->SetAttribute("EpochDuration", TimeValue(statsEpoch));
+        }
+        if (pdcpTraces && !adaptiveStatsEpoch)
+        {
+            lteHelper->EnablePdcpTraces();
+            lteHelper->GetPdcpStats()->SetAttribute("EpochDuration", TimeValue(statsEpoch));
+        }
+        if (adaptiveStatsEpoch)
+        {
+            // Same files and format, with one epoch per bearer
+            for (const std::string layer : {"Rlc", "Pdcp"})
+            {
+                if (!(layer == "Rlc" ? rlcTraces : pdcpTraces))
+                {
+                    continue;
+                }
+                Ptr<AdaptiveBearerStatsCalculator> stats =
+                    CreateObject<AdaptiveBearerStatsCalculator>();
+                stats->SetAttribute("Layer", StringValue("Lte" + layer));
+                stats->SetAttribute("DlOutputFilename", StringValue("Dl" + layer + "Stats.txt"));
+                stats->SetAttribute("UlOutputFilename", StringValue("Ul" + layer + "Stats.txt"));
+                stats->SetAttribute("MinEpoch", TimeValue(statsEpoch));
+                stats->SetAttribute("MaxEpoch", TimeValue(statsMaxEpoch));
+                stats->Install();
+                adaptiveStats.push_back(stats);
+            }
+        }
+        if (phyTraces || macTraces)
+        {
+            auto enableTraces = [lteHelper, phyTraces, macTraces]() {
+                MemoryAccounting::Scope scope("Trace calculators");
+                if (phyTraces)
+                {
+                    lteHelper->EnablePhyTraces();
+                }
+                if (macTraces)
+                {
+                    lteHelper->EnableMacTraces();
+                }
+            };
+            if (phyMacTracesStart.IsZero())
+            {
+                enableTraces();
+            }
+            else
+            {
+                Simulator::Schedule(phyMacTracesStart, enableTraces);
+            }
+        }
+    }
+
+    // KPIs of the early stop, sampled once the UEs are connected, every 100 ms
+    // or less in short runs
+    EarlyStopController earlyStop(MilliSeconds(100));
+    uint64_t earlyStopBytes = 0;
+    double earlyStopDelaySum = 0;
+    uint64_t earlyStopPduCount = 0;
+    if (enableEarlyStop)
+    {
+        earlyStop.AddKpi(
+            "throughput [Mb/s]",
+            [&earlyStopBytes](Time interval) {
+                double throughput =
+                    (ByteCounter - earlyStopBytes) * 8 / interval.GetSeconds() / 1e6;
+                earlyStopBytes = ByteCounter;
+                return throughput;
+            },
+            earlyStopPrecision);
+        earlyStop.AddKpi(
+            "RLC delay [ms]",
+            [&earlyStopDelaySum, &earlyStopPduCount](Time) {
+                double delay = RlcPduCount == earlyStopPduCount
+                                   ? NAN
+                                   : (RlcDelaySum - earlyStopDelaySum) /
+                                         (RlcPduCount - earlyStopPduCount) / 1e6;
+                earlyStopDelaySum = RlcDelaySum;
+                earlyStopPduCount = RlcPduCount;
+                return delay;
+            },
+            earlyStopPrecision);
+        Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/DrbCreated",
+                        MakeBoundCallback(&ConnectRlcRxPdu, MakeCallback(&RecordRlcDelay)));
+        earlyStop.FitInterval(simTime - attachWindow - Seconds(0.3));
+        earlyStop.Start(attachWindow + Seconds(0.3));
+    }
+
+    // Live metrics for lte-metrics-reader: only memory stores in the simulation thread
+    std::unique_ptr<ShmMetricsPublisher> metrics;
+    if (!metricsShmName.empty())
+    {
+        metrics = std::make_unique<ShmMetricsPublisher>(metricsShmName, metricsInterval);
+        metrics->AddCounter("dlRxBytes", []() { return ByteCounter; });
+        CellDlBytes.assign(enbDevs.GetN(), 0);
+        for (uint32_t i = 0; i < enbDevs.GetN(); i++)
+        {
+            Ptr<LteEnbNetDevice> enbDev = enbDevs.Get(i)->GetObject<LteEnbNetDevice>();
+            enbDev->GetMac()->TraceConnectWithoutContext(
+                "DlScheduling",
+                MakeBoundCallback(&RecordDlScheduling, i));
+            std::string cell = "cell" + std::to_string(enbDev->GetCellId());
+            metrics->AddCounter(cell + ".dlScheduledBytes", [i]() { return CellDlBytes[i]; });
+            metrics->AddGauge(cell + ".ueContexts", [enbDev]() {
+                ObjectMapValue ues;
+                enbDev->GetRrc()->GetAttribute("UeMap", ues);
+                return ues.GetN();
+            });
+        }
+        for (uint32_t k = 0; remoteHosts && k < remoteHosts->GetN(); k++)
+        {
+            // Device 0 is the loopback, 1 the SGi link, whose queue holds the downlink
+            Ptr<PointToPointNetDevice> sgi =
+                remoteHosts->GetNodes().Get(k)->GetDevice(1)->GetObject<PointToPointNetDevice>();
+            metrics->AddGauge("sgi" + std::to_string(k) + ".queuePackets",
+                              [sgi]() { return sgi->GetQueue()->GetNPackets(); });
+        }
+        metrics->Start();
+    }
+
+    if (throughputTrace)
+    {
+        bool firstWrite = true;
+        std::string rrcType = useIdealRrc ? "ideal_rrc" : "real_rrc";
+        std::string scheduler = macScheduler.substr(macScheduler.rfind(':') + 1);
+        std::ostringstream speed;
+        speed << ueSpeed;
+        std::string fileName = "rlf_dl_thrput_speed_" + speed.str() + "_" + scheduler + "_" +
+                               std::to_string(enbNodes.GetN()) + "_eNB_" + rrcType;
+        Simulator::Schedule(Seconds(0.47), &Throughput, firstWrite, throughputBin, fileName);
+    }
+
+    // connect custom trace sinks for RRC connection establishment and handover notification
+    if (handoverLog)
+    {
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/ConnectionEstablished",
+                        MakeCallback(&NotifyConnectionEstablishedEnb));
+        Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionEstablished",
+                        MakeCallback(&NotifyConnectionEstablishedUe));
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverStart",
+                        MakeCallback(&NotifyHandoverStartEnb));
+        Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/HandoverStart",
+                        MakeCallback(&NotifyHandoverStartUe));
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverEndOk",
+                        MakeCallback(&NotifyHandoverEndOkEnb));
+        Config::Connect("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
+                        MakeCallback(&NotifyHandoverEndOkUe));
+
+        // Hook a trace sink (the same one) to the four handover failure traces
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverFailureNoPreamble",
+                        MakeCallback(&NotifyHandoverFailure));
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverFailureMaxRach",
+                        MakeCallback(&NotifyHandoverFailure));
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverFailureLeaving",
+                        MakeCallback(&NotifyHandoverFailure));
+        Config::Connect("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverFailureJoining",
+                        MakeCallback(&NotifyHandoverFailure));
+    }
+
+    std::unique_ptr<RlfMonitor> rlf;
+    if (rlfMonitor)
+    {
+        rlf = std::make_unique<RlfMonitor>(ueNodes.GetN(), enbNodes.GetN());
+        rlf->Install();
+    }
+    std::unique_ptr<RlcBufferMonitor> rlcBuffers;
+    if (rlcBufferMonitor)
+    {
+        rlcBuffers = std::make_unique<RlcBufferMonitor>();
+        rlcBuffers->Install(enbDevs);
+    }
+
+    // Packets of the SGi and S1-U links, written to pcap on RLFs, handover
+    // failures and throughput drops only
+    std::unique_ptr<PcapRingCapture> pcapRing;
+    if (pcapRingSize > 0)
+    {
+        pcapRing = std::make_unique<PcapRingCapture>(pcapRingPrefix, pcapRingSize * 1000000ULL);
+        pcapRing->SetPostTriggerTime(pcapRingPostTrigger);
+        pcapRing->SetLog(&std::cout);
+        for (uint32_t k = 0; remoteHosts && k < remoteHosts->GetN(); k++)
+        {
+            pcapRing->AddLink("sgi" + std::to_string(k),
+                              PcapRingCapture::FindLink(remoteHosts->GetNodes().Get(k), pgw));
+        }
+        for (uint32_t i = 0; i < enbNodes.GetN(); i++)
+        {
+            pcapRing->AddLink("s1u" + std::to_string(i),
+                              PcapRingCapture::FindLink(enbNodes.Get(i), epcHelper->GetSgwNode()));
+        }
+        pcapRing->InstallLteTriggers();
+        if (pcapRingThroughput > 0)
+        {
+            pcapRing->SetThroughputTrigger(pcapRingThroughput, throughputBin);
+        }
+        for (const auto& t : ScenarioConfig::Split(pcapRingTriggerTimes))
+        {
+            Simulator::Schedule(Seconds(std::stod(t)),
+                                &PcapRingCapture::Trigger,
+                                pcapRing.get(),
+                                "at " + t + " s");
+        }
+    }
+
+    // To log the course change of UEs movements
+    if (logCourseChanges)
+    {
+        Config::Connect("/NodeList/*/$ns3::MobilityModel/CourseChange",
+                        MakeCallback(&CourseChange));
+    }
+
+    // Flow monitor
+    Ptr<FlowMonitor> flowmon;
+    FlowMonitorHelper flowmonHelper;
+    if (!flowMonitorFile.empty())
+    {
+        flowmon = flowmonHelper.InstallAll();
+    }
+
+    std::unique_ptr<AnimationInterface> anim;
+    if (!animationFile.empty())
+    {
+        anim = std::make_unique<AnimationInterface>(animationFile);
+    }
+
+    if (enableMemoryReport)
+    {
+        std::vector<Time> times;
+        for (const auto& t : ScenarioConfig::Split(memoryReportTimes))
+        {
+            times.push_back(Seconds(std::stod(t)));
+        }
+        MemoryAccounting::SetNodeRole(enbNodes, "eNB");
+        MemoryAccounting::SetNodeRole(ueNodes, "UE");
+        if (remoteHosts)
+        {
+            MemoryAccounting::SetNodeRole(remoteHosts->GetNodes(), "remote host");
+        }
+        MemoryAccounting::SetNodeRole(NodeContainer(pgw), "EPC");
+        MemoryAccounting::ScheduleSnapshots(times, &std::cout);
+    }
+
+    Simulator::Stop(simTime);
+    setupTimer.Start("Simulator::Run");
+    if (enableMemoryReport)
+    {
+        MemoryAccounting::EnableRuntimeAttribution(true);
+    }
+    Simulator::Run();
+    if (enableMemoryReport)
+    {
+        MemoryAccounting::EnableRuntimeAttribution(false);
+    }
+    if (shardExchange)
+    {
+        shardExchange->Finish();
+    }
+    for (auto& recorder : schedulerRecorders)
+    {
+        recorder->Close();
+    }
+    if (pcapRing)
+    {
+        pcapRing->Finish();
+    }
+    if (metrics)
+    {
+        metrics->Stop();
+    }
+    for (auto& stats : adaptiveStats)
+    {
+        stats->Flush();
+    }
+    setupTimer.Print(std::cout);
+    std::cout << "Events executed: " << Simulator::GetEventCount() << std::endl;
+    if (rlf)
+    {
+        rlf->Print(std::cout);
+    }
+    if (rlcBuffers)
+    {
+        rlcBuffers->Print(std::cout);
+    }
+    if (enableEarlyStop)
+    {
+        earlyStop.Print(std::cout);
+    }
+    if (enableMemoryReport)
+    {
+        MemoryAccounting::Report(&std::cout);
+    }
+    else if (memoryPool)
+    {
+        MemoryPool::Print(std::cout);
+    }
+    if (flowmon)
+    {
+        flowmon->SerializeToXmlFile(flowMonitorFile, true, true);
+    }
+    if (dlTraffic || fullBufferDl)
+    {
+        double averageThroughput = ByteCounter * 8 / 1e6 / Simulator::Now().GetSeconds();
+        std::cout << "Average downlink throughput: " << averageThroughput << " Mbit/s"
+                  << std::endl;
+    }
+    if (memoryPool)
+    {
+        MemoryPool::BeginTeardown();
+    }
+    auto destroyStart = std::chrono::steady_clock::now();
+    Simulator::Destroy();
+    std::cout << "Simulator::Destroy: "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - destroyStart)
+                     .count()
+              << " s" << std::endl;
+    return 0;
+}
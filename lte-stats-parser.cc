@@ -0,0 +1,781 @@
+#include "scenario-config.h"
+
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace ns3;
+
+/*
+ * Extracts per-UE and per-cell KPIs from the statistics files of a run, e.g.
+ *
+ *   ./ns3 run "lte-stats-parser --outPrefix=run1_kpi
+ *              --throughput=rlf_dl_thrput_speed_0_RrFfMacScheduler_4_eNB_ideal_rrc"
+ *
+ * Each file is mapped read-only and cut at line boundaries into one chunk per
+ * thread. Every thread parses its chunk with std::from_chars into its own
+ * tables, which are merged at the end, so parsing scales with the cores and
+ * never copies a line. Missing files are skipped. It writes
+ *
+ *   <outPrefix>_ue.csv        per IMSI: RLC/PDCP throughput and delay
+ *                             percentiles, MAC mean MCS, HARQ retransmissions
+ *   <outPrefix>_cell.csv      the same per cell
+ *   <outPrefix>_mcs_ue.csv    MCS distribution (transport blocks per MCS)
+ *   <outPrefix>_mcs_cell.csv
+ *
+ * and prints the statistics of the throughput traces. The RLC and PDCP files
+ * only hold the mean delay of each epoch, so the delay percentiles are those
+ * of the epoch means weighted by their PDU count. DlMacStats has no HARQ
+ * information: retransmissions and BLER come from DlRxPhyStats (rv > 0 and
+ * correct == 0).
+ */
+
+/// Read-only mapping of a whole file
+class MappedFile
+{
+  public:
+    /**
+     * \param fileName The file name.
+     */
+    MappedFile(const std::string& fileName)
+        : m_data(nullptr),
+          m_size(0)
+    {
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat st;
+        NS_ABORT_MSG_IF(fstat(fd, &st) != 0, "Cannot stat " << fileName);
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size > 0)
+        {
+            void* addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            NS_ABORT_MSG_IF(addr == MAP_FAILED, "Cannot map " << fileName);
+            madvise(addr, m_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+            m_data = static_cast<const char*>(addr);
+        }
+        close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (m_data)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    /// \return False if the file does not exist or is empty.
+    bool IsValid() const
+    {
+        return m_data != nullptr;
+    }
+
+    /// \return The first byte.
+    const char* Begin() const
+    {
+        return m_data;
+    }
+
+    /// \return Past the last byte.
+    const char* End() const
+    {
+        return m_data + m_size;
+    }
+
+    /// \return The size in bytes.
+    size_t GetSize() const
+    {
+        return m_size;
+    }
+
+  private:
+    const char* m_data; //!< Mapped data
+    size_t m_size;      //!< File size
+};
+
+/// Parses the blank separated fields of one line
+class FieldReader
+{
+  public:
+    /**
+     * \param begin First character of the line.
+     * \param end End of the line.
+     */
+    FieldReader(const char* begin, const char* end)
+        : m_p(begin),
+          m_end(end)
+    {
+    }
+
+    /**
+     * \param [out] value The next field.
+     * \return False if the line has no more valid field.
+     */
+    template <typename T>
+    bool Next(T& value)
+    {
+        SkipBlanks();
+        auto result = std::from_chars(m_p, m_end, value);
+        if (result.ec != std::errc())
+        {
+            return false;
+        }
+        m_p = result.ptr;
+        return true;
+    }
+
+    /**
+     * Skip fields.
+     * \param n Number of fields.
+     */
+    void Skip(uint32_t n)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            SkipBlanks();
+            while (m_p < m_end && *m_p != '\t' && *m_p != ' ')
+            {
+                m_p++;
+            }
+        }
+    }
+
+    /**
+     * Skip characters, e.g. the '+' of a Time printed with As().
+     * \param c The character.
+     */
+    void SkipChar(char c)
+    {
+        SkipBlanks();
+        if (m_p < m_end && *m_p == c)
+        {
+            m_p++;
+        }
+    }
+
+  private:
+    /// Skip tabs and spaces
+    void SkipBlanks()
+    {
+        while (m_p < m_end && (*m_p == '\t' || *m_p == ' '))
+        {
+            m_p++;
+        }
+    }
+
+    const char* m_p;   //!< Current position
+    const char* m_end; //!< End of the line
+};
+
+/**
+ * Parse a file in parallel chunks. Lines starting with '%' are skipped.
+ *
+ * \param file The mapped file.
+ * \param numThreads Number of threads.
+ * \param parseLine Parses one line into the table of its thread.
+ * \return One table per thread.
+ */
+template <typename Table>
+std::vector<Table>
+ParseParallel(const MappedFile& file,
+              uint32_t numThreads,
+              std::function<void(Table&, FieldReader&)> parseLine)
+{
+    // Chunk boundaries moved to the next line start
+    std::vector<const char*> bounds = {file.Begin()};
+    for (uint32_t t = 1; t < numThreads; t++)
+    {
+        const char* p = file.Begin() + file.GetSize() * t / numThreads;
+        p = std::max(p, bounds.back());
+        const char* nl = static_cast<const char*>(memchr(p, '\n', file.End() - p));
+        bounds.push_back(nl ? nl + 1 : file.End());
+    }
+    bounds.push_back(file.End());
+
+    std::vector<Table> tables(numThreads);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back([&, t]() {
+            const char* p = bounds[t];
+            const char* end = bounds[t + 1];
+            while (p < end)
+            {
+                const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+                const char* eol = nl ? nl : end;
+                if (eol > p && *p != '%')
+                {
+                    FieldReader fields(p, eol);
+                    parseLine(tables[t], fields);
+                }
+                p = eol + 1;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    return tables;
+}
+
+/// RLC or PDCP statistics of a UE or a cell
+struct BearerKpi
+{
+    double txBytes = 0;                                //!< Transmitted bytes
+    double rxBytes = 0;                                //!< Received bytes
+    double start = std::numeric_limits<double>::max(); //!< First epoch start, in s
+    double end = 0;                                    //!< Last epoch end, in s
+    std::vector<std::pair<double, double>> delays;     //!< (epoch mean delay, PDUs)
+
+    /**
+     * \param other Statistics to add.
+     */
+    void Merge(const BearerKpi& other)
+    {
+        txBytes += other.txBytes;
+        rxBytes += other.rxBytes;
+        start = std::min(start, other.start);
+        end = std::max(end, other.end);
+        delays.insert(delays.end(), other.delays.begin(), other.delays.end());
+    }
+
+    /**
+     * \param q Quantile, between 0 and 1.
+     * \return The weighted quantile of the epoch delays, in s.
+     */
+    double DelayQuantile(double q)
+    {
+        if (delays.empty())
+        {
+            return 0;
+        }
+        std::sort(delays.begin(), delays.end());
+        double total = 0;
+        for (const auto& d : delays)
+        {
+            total += d.second;
+        }
+        double acc = 0;
+        for (const auto& d : delays)
+        {
+            acc += d.second;
+            if (acc >= q * total)
+            {
+                return d.first;
+            }
+        }
+        return delays.back().first;
+    }
+
+    /// \return The mean delay weighted by the PDU count, in s.
+    double DelayMean() const
+    {
+        double sum = 0;
+        double total = 0;
+        for (const auto& d : delays)
+        {
+            sum += d.first * d.second;
+            total += d.second;
+        }
+        return total > 0 ? sum / total : 0;
+    }
+};
+
+/// MAC and PHY statistics of a UE or a cell
+struct LinkKpi
+{
+    uint64_t tbs = 0;                  //!< Scheduled transport blocks
+    double bytes = 0;                  //!< Scheduled bytes
+    std::array<uint64_t, 32> mcs = {}; //!< Transport blocks per MCS
+    uint64_t rxTbs = 0;                //!< Received transport blocks
+    uint64_t retx = 0;                 //!< HARQ retransmissions
+    uint64_t errors = 0;               //!< Transport blocks received with errors
+
+    /**
+     * \param other Statistics to add.
+     */
+    void Merge(const LinkKpi& other)
+    {
+        tbs += other.tbs;
+        bytes += other.bytes;
+        for (size_t i = 0; i < mcs.size(); i++)
+        {
+            mcs[i] += other.mcs[i];
+        }
+        rxTbs += other.rxTbs;
+        retx += other.retx;
+        errors += other.errors;
+    }
+
+    /// \return The mean MCS of the transport blocks.
+    double MeanMcs() const
+    {
+        double sum = 0;
+        for (size_t i = 0; i < mcs.size(); i++)
+        {
+            sum += static_cast<double>(i) * mcs[i];
+        }
+        return tbs > 0 ? sum / tbs : 0;
+    }
+};
+
+/// Tables of one parsing thread, keyed by IMSI and by cell id
+template <typename Kpi>
+struct KpiTables
+{
+    std::unordered_map<uint64_t, Kpi> ues;   //!< Per IMSI
+    std::unordered_map<uint64_t, Kpi> cells; //!< Per cell id
+};
+
+/**
+ * Merge the tables of the threads.
+ * \param tables Tables of each thread.
+ * \return The merged tables, ordered by key.
+ */
+template <typename Kpi>
+std::pair<std::map<uint64_t, Kpi>, std::map<uint64_t, Kpi>>
+MergeTables(std::vector<KpiTables<Kpi>>& tables)
+{
+    std::pair<std::map<uint64_t, Kpi>, std::map<uint64_t, Kpi>> merged;
+    for (auto& table : tables)
+    {
+        for (const auto& kv : table.ues)
+        {
+            merged.first[kv.first].Merge(kv.second);
+        }
+        for (const auto& kv : table.cells)
+        {
+            merged.second[kv.first].Merge(kv.second);
+        }
+    }
+    return merged;
+}
+
+/**
+ * Parse DlRlcStats.txt or DlPdcpStats.txt:
+ * start end CellId IMSI RNTI LCID nTxPDUs TxBytes nRxPDUs RxBytes delay ...
+ *
+ * \param fileName The file name.
+ * \param numThreads Number of threads.
+ * \return Per IMSI and per cell statistics.
+ */
+static std::pair<std::map<uint64_t, BearerKpi>, std::map<uint64_t, BearerKpi>>
+ParseBearerStats(const std::string& fileName, uint32_t numThreads)
+{
+    MappedFile file(fileName);
+    if (!file.IsValid())
+    {
+        std::cout << "Skipping " << fileName << ": not found or empty" << std::endl;
+        return {};
+    }
+    auto tables = ParseParallel<KpiTables<BearerKpi>>(
+        file,
+        numThreads,
+        [](KpiTables<BearerKpi>& table, FieldReader& fields) {
+            double start;
+            double end;
+            uint64_t cellId;
+            uint64_t imsi;
+            uint64_t txPdus;
+            uint64_t txBytes;
+            uint64_t rxPdus;
+            uint64_t rxBytes;
+            double delay;
+            if (!fields.Next(start) || !fields.Next(end) || !fields.Next(cellId) ||
+                !fields.Next(imsi))
+            {
+                return;
+            }
+            fields.Skip(2); // RNTI, LCID
+            if (!fields.Next(txPdus) || !fields.Next(txBytes) || !fields.Next(rxPdus) ||
+                !fields.Next(rxBytes) || !fields.Next(delay))
+            {
+                return;
+            }
+            for (BearerKpi* kpi : {&table.ues[imsi], &table.cells[cellId]})
+            {
+                kpi->txBytes += txBytes;
+                kpi->rxBytes += rxBytes;
+                kpi->start = std::min(kpi->start, start);
+                kpi->end = std::max(kpi->end, end);
+                if (rxPdus > 0)
+                {
+                    kpi->delays.emplace_back(delay, rxPdus);
+                }
+            }
+        });
+    return MergeTables(tables);
+}
+
+/**
+ * Parse DlMacStats.txt:
+ * time cellId IMSI frame sframe RNTI mcsTb1 sizeTb1 mcsTb2 sizeTb2 ccId
+ *
+ * \param fileName The file name.
+ * \param numThreads Number of threads.
+ * \param [in,out] ues Per IMSI statistics.
+ * \param [in,out] cells Per cell statistics.
+ */
+static void
+ParseMacStats(const std::string& fileName,
+              uint32_t numThreads,
+              std::map<uint64_t, LinkKpi>& ues,
+              std::map<uint64_t, LinkKpi>& cells)
+{
+    MappedFile file(fileName);
+    if (!file.IsValid())
+    {
+        std::cout << "Skipping " << fileName << ": not found or empty" << std::endl;
+        return;
+    }
+    auto tables = ParseParallel<KpiTables<LinkKpi>>(
+        file,
+        numThreads,
+        [](KpiTables<LinkKpi>& table, FieldReader& fields) {
+            double time;
+            uint64_t cellId;
+            uint64_t imsi;
+            uint32_t mcs[2];
+            uint64_t size[2];
+            if (!fields.Next(time) || !fields.Next(cellId) || !fields.Next(imsi))
+            {
+                return;
+            }
+            fields.Skip(3); // frame, sframe, RNTI
+            if (!fields.Next(mcs[0]) || !fields.Next(size[0]) || !fields.Next(mcs[1]) ||
+                !fields.Next(size[1]))
+            {
+                return;
+            }
+            for (LinkKpi* kpi : {&table.ues[imsi], &table.cells[cellId]})
+            {
+                for (int tb = 0; tb < 2; tb++)
+                {
+                    if (size[tb] > 0)
+                    {
+                        kpi->tbs++;
+                        kpi->bytes += size[tb];
+                        kpi->mcs[std::min<uint32_t>(mcs[tb], 31)]++;
+                    }
+                }
+            }
+        });
+    auto merged = MergeTables(tables);
+    for (const auto& kv : merged.first)
+    {
+        ues[kv.first].Merge(kv.second);
+    }
+    for (const auto& kv : merged.second)
+    {
+        cells[kv.first].Merge(kv.second);
+    }
+}
+
+/**
+ * Parse DlRxPhyStats.txt:
+ * time cellId IMSI RNTI txMode layer mcs size rv ndi correct ccId
+ *
+ * \param fileName The file name.
+ * \param numThreads Number of threads.
+ * \param [in,out] ues Per IMSI statistics.
+ * \param [in,out] cells Per cell statistics.
+ */
+static void
+ParsePhyStats(const std::string& fileName,
+              uint32_t numThreads,
+              std::map<uint64_t, LinkKpi>& ues,
+              std::map<uint64_t, LinkKpi>& cells)
+{
+    MappedFile file(fileName);
+    if (!file.IsValid())
+    {
+        std::cout << "Skipping " << fileName << ": not found or empty" << std::endl;
+        return;
+    }
+    auto tables = ParseParallel<KpiTables<LinkKpi>>(
+        file,
+        numThreads,
+        [](KpiTables<LinkKpi>& table, FieldReader& fields) {
+            double time;
+            uint64_t cellId;
+            uint64_t imsi;
+            uint32_t rv;
+            uint32_t ndi;
+            uint32_t correct;
+            if (!fields.Next(time) || !fields.Next(cellId) || !fields.Next(imsi))
+            {
+                return;
+            }
+            fields.Skip(5); // RNTI, txMode, layer, mcs, size
+            if (!fields.Next(rv) || !fields.Next(ndi) || !fields.Next(correct))
+            {
+                return;
+            }
+            for (LinkKpi* kpi : {&table.ues[imsi], &table.cells[cellId]})
+            {
+                kpi->rxTbs++;
+                kpi->retx += rv > 0 ? 1 : 0;
+                kpi->errors += correct == 0 ? 1 : 0;
+            }
+        });
+    auto merged = MergeTables(tables);
+    for (const auto& kv : merged.first)
+    {
+        ues[kv.first].Merge(kv.second);
+    }
+    for (const auto& kv : merged.second)
+    {
+        cells[kv.first].Merge(kv.second);
+    }
+}
+
+/**
+ * Print the statistics of a throughput trace written by Throughput():
+ * one "+<time>s <Mb/s>" line per bin.
+ *
+ * \param fileName The file name.
+ */
+static void
+PrintThroughputTrace(const std::string& fileName)
+{
+    MappedFile file(fileName);
+    if (!file.IsValid())
+    {
+        std::cout << "Skipping " << fileName << ": not found or empty" << std::endl;
+        return;
+    }
+    std::vector<double> samples;
+    const char* p = file.Begin();
+    while (p < file.End())
+    {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', file.End() - p));
+        const char* eol = nl ? nl : file.End();
+        FieldReader fields(p, eol);
+        double time;
+        double throughput;
+        fields.SkipChar('+');
+        if (fields.Next(time))
+        {
+            fields.SkipChar('s');
+            if (fields.Next(throughput))
+            {
+                samples.push_back(throughput);
+            }
+        }
+        p = eol + 1;
+    }
+    if (samples.empty())
+    {
+        std::cout << fileName << ": no samples" << std::endl;
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double s : samples)
+    {
+        sum += s;
+    }
+    auto quantile = [&samples](double q) {
+        return samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))];
+    };
+    std::cout << fileName << ": " << samples.size() << " bins, mean " << sum / samples.size()
+              << " Mb/s, min " << samples.front() << ", p5 " << quantile(0.05) << ", p50 "
+              << quantile(0.5) << ", p95 " << quantile(0.95) << ", max " << samples.back()
+              << std::endl;
+}
+
+/**
+ * Write the RLC, PDCP, MAC and PHY KPIs of each UE or cell.
+ *
+ * \param fileName The CSV file name.
+ * \param keyName Name of the key column.
+ * \param rlc RLC statistics.
+ * \param pdcp PDCP statistics.
+ * \param link MAC and PHY statistics.
+ */
+static void
+WriteKpis(const std::string& fileName,
+          const std::string& keyName,
+          std::map<uint64_t, BearerKpi>& rlc,
+          std::map<uint64_t, BearerKpi>& pdcp,
+          std::map<uint64_t, LinkKpi>& link)
+{
+    std::set<uint64_t> keys;
+    for (const auto& kv : rlc)
+    {
+        keys.insert(kv.first);
+    }
+    for (const auto& kv : pdcp)
+    {
+        keys.insert(kv.first);
+    }
+    for (const auto& kv : link)
+    {
+        keys.insert(kv.first);
+    }
+
+    std::ofstream out(fileName);
+    NS_ABORT_MSG_IF(!out.is_open(), "Cannot write " << fileName);
+    out << keyName
+        << ",rlcThroughputMbps,rlcDelayMeanMs,rlcDelayP50Ms,rlcDelayP95Ms,rlcDelayP99Ms,"
+           "pdcpThroughputMbps,pdcpDelayMeanMs,pdcpDelayP95Ms,macTbs,macMbps,macMeanMcs,"
+           "phyRxTbs,harqRetx,harqRetxRate,bler"
+        << std::endl;
+    for (uint64_t key : keys)
+    {
+        out << key;
+        for (auto* table : {&rlc, &pdcp})
+        {
+            auto it = table->find(key);
+            BearerKpi kpi = it != table->end() ? it->second : BearerKpi();
+            double span = kpi.end > kpi.start ? kpi.end - kpi.start : 0;
+            out << "," << (span > 0 ? kpi.rxBytes * 8 / span / 1e6 : 0) << ","
+                << kpi.DelayMean() * 1e3;
+            if (table == &rlc)
+            {
+                out << "," << kpi.DelayQuantile(0.5) * 1e3 << ","
+                    << kpi.DelayQuantile(0.95) * 1e3 << "," << kpi.DelayQuantile(0.99) * 1e3;
+            }
+            else
+            {
+                out << "," << kpi.DelayQuantile(0.95) * 1e3;
+            }
+        }
+        auto it = link.find(key);
+        LinkKpi kpi = it != link.end() ? it->second : LinkKpi();
+        auto rlcIt = rlc.find(key);
+        double span = rlcIt != rlc.end() && rlcIt->second.end > rlcIt->second.start
+                          ? rlcIt->second.end - rlcIt->second.start
+                          : 0;
+        out << "," << kpi.tbs << "," << (span > 0 ? kpi.bytes * 8 / span / 1e6 : 0) << ","
+            << kpi.MeanMcs() << "," << kpi.rxTbs << "," << kpi.retx << ","
+            << (kpi.rxTbs > 0 ? static_cast<double>(kpi.retx) / kpi.rxTbs : 0) << ","
+            << (kpi.rxTbs > 0 ? static_cast<double>(kpi.errors) / kpi.rxTbs : 0) << std::endl;
+    }
+}
+
+/**
+ * Write the MCS distribution of each UE or cell.
+ *
+ * \param fileName The CSV file name.
+ * \param keyName Name of the key column.
+ * \param link MAC statistics.
+ */
+static void
+WriteMcs(const std::string& fileName,
+         const std::string& keyName,
+         const std::map<uint64_t, LinkKpi>& link)
+{
+    std::ofstream out(fileName);
+    NS_ABORT_MSG_IF(!out.is_open(), "Cannot write " << fileName);
+    out << keyName;
+    for (int m = 0; m < 29; m++)
+    {
+        out << ",mcs" << m;
+    }
+    out << std::endl;
+    for (const auto& kv : link)
+    {
+        if (kv.second.tbs == 0)
+        {
+            continue;
+        }
+        out << kv.first;
+        for (int m = 0; m < 29; m++)
+        {
+            out << "," << kv.second.mcs[m];
+        }
+        out << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::string rlcFile = "DlRlcStats.txt";
+    std::string pdcpFile = "DlPdcpStats.txt";
+    std::string macFile = "DlMacStats.txt";
+    std::string phyFile = "DlRxPhyStats.txt";
+    std::string throughputFiles = "";
+    std::string outPrefix = "kpi";
+    uint32_t numThreads = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("rlc", "RLC statistics, empty to skip", rlcFile);
+    cmd.AddValue("pdcp", "PDCP statistics, empty to skip", pdcpFile);
+    cmd.AddValue("mac", "MAC statistics, empty to skip", macFile);
+    cmd.AddValue("phy", "PHY reception statistics, empty to skip", phyFile);
+    cmd.AddValue("throughput", "Comma separated throughput traces", throughputFiles);
+    cmd.AddValue("outPrefix", "Prefix of the CSV outputs", outPrefix);
+    cmd.AddValue("threads", "Parsing threads, 0 for one per core", numThreads);
+    cmd.Parse(argc, argv);
+
+    if (numThreads == 0)
+    {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t totalBytes = 0;
+    for (const auto& name : {rlcFile, pdcpFile, macFile, phyFile})
+    {
+        struct stat st;
+        if (!name.empty() && stat(name.c_str(), &st) == 0)
+        {
+            totalBytes += st.st_size;
+        }
+    }
+
+    std::pair<std::map<uint64_t, BearerKpi>, std::map<uint64_t, BearerKpi>> rlc;
+    std::pair<std::map<uint64_t, BearerKpi>, std::map<uint64_t, BearerKpi>> pdcp;
+    std::map<uint64_t, LinkKpi> ueLink;
+    std::map<uint64_t, LinkKpi> cellLink;
+    if (!rlcFile.empty())
+    {
+        rlc = ParseBearerStats(rlcFile, numThreads);
+    }
+    if (!pdcpFile.empty())
+    {
+        pdcp = ParseBearerStats(pdcpFile, numThreads);
+    }
+    if (!macFile.empty())
+    {
+        ParseMacStats(macFile, numThreads, ueLink, cellLink);
+    }
+    if (!phyFile.empty())
+    {
+        ParsePhyStats(phyFile, numThreads, ueLink, cellLink);
+    }
+    double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    WriteKpis(outPrefix + "_ue.csv", "imsi", rlc.first, pdcp.first, ueLink);
+    WriteKpis(outPrefix + "_cell.csv", "cellId", rlc.second, pdcp.second, cellLink);
+    WriteMcs(outPrefix + "_mcs_ue.csv", "imsi", ueLink);
+    WriteMcs(outPrefix + "_mcs_cell.csv", "cellId", cellLink);
+    std::cout << "Parsed " << totalBytes / 1e6 << " MB in " << elapsed << " s with "
+              << numThreads << " threads (" << (elapsed > 0 ? totalBytes / 1e6 / elapsed : 0)
+              << " MB/s): " << rlc.first.size() << " UEs, " << rlc.second.size()
+              << " cells, KPIs in " << outPrefix << "_*.csv" << std::endl;
+
+    for (const auto& name : ScenarioConfig::Split(throughputFiles))
+    {
+        PrintThroughputTrace(name);
+    }
+    return 0;
+}
@@ -0,0 +1,464 @@
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+/*
+ * Heap accounting per protocol layer and per node.
+ *
+ * Built with -DMEMORY_ACCOUNTING, this header replaces the global operator
+ * new/delete, so it must then be included by exactly one translation unit of
+ * a program (a scratch scenario is a single translation unit). Every
+ * allocation carries a 16 byte prefix recording its size, the layer that was
+ * active when it was made, and the node it belongs to. The hook is not
+ * thread-safe, and costs every allocation of the program, so without the
+ * flag it is left out: the scopes are then only bookkeeping and nothing is
+ * counted (HOOKED is false).
+ *
+ * The layer and node are set with MemoryAccounting::Scope around the setup
+ * phases of a scenario (installing devices, stacks, traces). While the
+ * simulation runs, allocations are charged to the node owning the executing
+ * event (its context), which is where per-UE RLC buffers and packets show up.
+ *
+ * Once MemoryPool::Enable() is called, the blocks (header included) come
+ * from MemoryPool. The pool does not need this hook: built with
+ * -DMEMORY_POOL alone, memory-pool.h replaces operator new/delete with the
+ * pool only, without headers or counters.
+ */
+
+#include "memory-pool.h"
+
+#include <ns3/core-module.h>
+#include <ns3/node-container.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Counters behind the operator new/delete hook, and the report tables.
+ */
+class MemoryAccounting
+{
+  public:
+#ifdef MEMORY_ACCOUNTING
+    /// Whether operator new/delete go through the accounting
+    static constexpr bool HOOKED = true;
+#else
+    /// Whether operator new/delete go through the accounting
+    static constexpr bool HOOKED = false;
+#endif
+
+    /// Node id used for allocations outside of any node
+    static constexpr uint32_t NO_NODE = 0xffffffff;
+
+    /// Maximum number of distinct layers
+    static constexpr uint16_t MAX_LAYERS = 64;
+
+    /// Prefix stored in front of every allocation
+    struct alignas(16) BlockHeader
+    {
+        uint64_t size;  //!< Requested size in bytes
+        uint32_t node;  //!< Owning node, or NO_NODE
+        uint16_t layer; //!< Layer index
+    };
+
+    /// Per layer counters
+    struct LayerCounters
+    {
+        int64_t liveBytes;   //!< Bytes currently allocated
+        int64_t peakBytes;   //!< Highest value of liveBytes
+        uint64_t allocCount; //!< Number of allocations
+    };
+
+    /**
+     * Sets the layer, and optionally the node, charged for allocations made
+     * during its lifetime. Scopes nest.
+     */
+    class Scope
+    {
+      public:
+        /**
+         * \param layer Name of the layer or object type being built.
+         * \param node Id of the node being built, NO_NODE if none.
+         */
+        Scope(const std::string& layer, uint32_t node = NO_NODE)
+            : m_prevLayer(State().currentLayer),
+              m_prevNode(State().currentNode)
+        {
+            uint16_t index = RegisterLayer(layer);
+            State().currentLayer = index;
+            State().currentNode = node;
+        }
+
+        ~Scope()
+        {
+            State().currentLayer = m_prevLayer;
+            State().currentNode = m_prevNode;
+        }
+
+      private:
+        uint16_t m_prevLayer; //!< Layer active before this scope
+        uint32_t m_prevNode;  //!< Node active before this scope
+    };
+
+    /**
+     * \param name Layer name.
+     * \return The index of the layer, registering it if needed.
+     */
+    static uint16_t RegisterLayer(const std::string& name)
+    {
+        auto& state = State();
+        for (uint16_t i = 0; i < state.numLayers; i++)
+        {
+            if (state.layerNames[i] == name)
+            {
+                return i;
+            }
+        }
+        NS_ABORT_MSG_IF(state.numLayers == MAX_LAYERS, "Too many memory accounting layers");
+        state.layerNames[state.numLayers] = name;
+        return state.numLayers++;
+    }
+
+    /**
+     * Group nodes under a role (eNB, UE, EPC...) in the per node tables.
+     *
+     * \param nodes The nodes.
+     * \param role The role name.
+     */
+    static void SetNodeRole(NodeContainer nodes, const std::string& role)
+    {
+        auto& roles = State().nodeRoles;
+        for (uint32_t i = 0; i < nodes.GetN(); i++)
+        {
+            uint32_t id = nodes.Get(i)->GetId();
+            if (roles.size() <= id)
+            {
+                roles.resize(id + 1, "other");
+            }
+            roles[id] = role;
+        }
+    }
+
+    /**
+     * Charge allocations made by events to the node of the event context.
+     * Must be disabled before Simulator::Destroy(), when the simulator
+     * implementation stops being available.
+     *
+     * \param enabled Whether runtime attribution is on.
+     */
+    static void EnableRuntimeAttribution(bool enabled)
+    {
+        State().runtimeAttribution = enabled;
+        State().currentLayer = RegisterLayer(enabled ? "runtime" : "other");
+    }
+
+    /**
+     * Print the report tables at the given simulation times.
+     *
+     * \param times The snapshot times.
+     * \param os The output stream.
+     */
+    static void ScheduleSnapshots(const std::vector<Time>& times, std::ostream* os)
+    {
+        for (const auto& t : times)
+        {
+            Simulator::Schedule(t, &MemoryAccounting::Report, os);
+        }
+    }
+
+    /**
+     * Print the per layer and per node role tables.
+     * \param os The output stream.
+     */
+    static void Report(std::ostream* os)
+    {
+        auto& state = State();
+        bool runtime = state.runtimeAttribution;
+        state.runtimeAttribution = false; // the report itself allocates
+
+        std::ostream& out = *os;
+        out << "Memory at " << Simulator::Now().As(Time::S) << std::endl;
+        out << "  " << std::left << std::setw(32) << "layer" << std::right << std::setw(14)
+            << "live [KiB]" << std::setw(14) << "peak [KiB]" << std::setw(14) << "allocs"
+            << std::endl;
+        int64_t total = 0;
+        for (uint16_t i = 0; i < state.numLayers; i++)
+        {
+            const LayerCounters& c = state.layers[i];
+            if (c.allocCount == 0)
+            {
+                continue;
+            }
+            out << "  " << std::left << std::setw(32) << state.layerNames[i] << std::right
+                << std::setw(14) << c.liveBytes / 1024 << std::setw(14) << c.peakBytes / 1024
+                << std::setw(14) << c.allocCount << std::endl;
+            total += c.liveBytes;
+        }
+        out << "  " << std::left << std::setw(32) << "total" << std::right << std::setw(14)
+            << total / 1024 << std::endl;
+
+        // Aggregate per node by role
+        struct RoleSummary
+        {
+            uint32_t nodes = 0;
+            int64_t bytes = 0;
+            uint32_t maxNode = 0;
+            int64_t maxBytes = 0;
+        };
+
+        std::map<std::string, RoleSummary> roles;
+        for (uint32_t id = 0; id < state.nodeBytes.size(); id++)
+        {
+            std::string role = id < state.nodeRoles.size() ? state.nodeRoles[id] : "other";
+            RoleSummary& r = roles[role];
+            if (r.nodes == 0 || state.nodeBytes[id] > r.maxBytes)
+            {
+                r.maxNode = id;
+                r.maxBytes = state.nodeBytes[id];
+            }
+            r.nodes++;
+            r.bytes += state.nodeBytes[id];
+        }
+        out << "  " << std::left << std::setw(32) << "node role" << std::right << std::setw(14)
+            << "nodes" << std::setw(14) << "live [KiB]" << std::setw(14) << "KiB/node"
+            << std::setw(14) << "max node" << std::endl;
+        for (const auto& r : roles)
+        {
+            out << "  " << std::left << std::setw(32) << r.first << std::right << std::setw(14)
+                << r.second.nodes << std::setw(14) << r.second.bytes / 1024 << std::setw(14)
+                << r.second.bytes / 1024 / r.second.nodes << std::setw(14) << r.second.maxNode
+                << std::endl;
+        }
+        out << "  " << std::left << std::setw(32) << "no node" << std::right << std::setw(14)
+            << "-" << std::setw(14) << state.noNodeBytes / 1024 << std::endl;
+        MemoryPool::Print(out);
+
+        state.runtimeAttribution = runtime;
+    }
+
+    /// \cond PRIVATE
+    /// Allocator for the internal tables, bypassing the accounting hook
+    template <typename T>
+    struct RawAllocator
+    {
+        using value_type = T;
+
+        RawAllocator() = default;
+
+        template <typename U>
+        RawAllocator(const RawAllocator<U>&)
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            void* p = std::malloc(n * sizeof(T));
+            if (!p)
+            {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, size_t)
+        {
+            std::free(p);
+        }
+
+        bool operator==(const RawAllocator&) const
+        {
+            return true;
+        }
+
+        bool operator!=(const RawAllocator&) const
+        {
+            return false;
+        }
+    };
+
+    /// Global accounting state
+    struct AccountingState
+    {
+        LayerCounters layers[MAX_LAYERS];   //!< Counters per layer
+        std::string layerNames[MAX_LAYERS]; //!< Layer names
+        uint16_t numLayers;                 //!< Number of registered layers
+        uint16_t currentLayer;              //!< Layer charged for new allocations
+        uint32_t currentNode;               //!< Node charged for new allocations
+        bool runtimeAttribution;            //!< Whether to use the event context
+        int64_t noNodeBytes;                //!< Live bytes outside of any node
+        std::vector<int64_t, RawAllocator<int64_t>> nodeBytes; //!< Live bytes per node
+        std::vector<std::string> nodeRoles;                    //!< Role of each node
+    };
+
+    /**
+     * The state is a function static built in raw memory, so that it exists
+     * before the first allocation of the program and is never destroyed while
+     * static destructors still free memory.
+     *
+     * \return The global accounting state.
+     */
+    static AccountingState& State()
+    {
+        static AccountingState* state = [] {
+            void* raw = std::malloc(sizeof(AccountingState));
+            auto* s = new (raw) AccountingState();
+            s->layerNames[0] = "other";
+            s->numLayers = 1;
+            s->currentLayer = 0;
+            s->currentNode = NO_NODE;
+            s->runtimeAttribution = false;
+            s->noNodeBytes = 0;
+            return s;
+        }();
+        return *state;
+    }
+
+    /**
+     * Allocate a block and charge it to the current layer and node.
+     * \param size Requested size.
+     * \return The user pointer, nullptr on failure.
+     */
+    static void* Allocate(size_t size)
+    {
+        void* block = MemoryPool::Allocate(sizeof(BlockHeader) + size);
+        if (!block)
+        {
+            block = std::malloc(sizeof(BlockHeader) + size);
+        }
+        auto* header = static_cast<BlockHeader*>(block);
+        if (!header)
+        {
+            return nullptr;
+        }
+        auto& state = State();
+        uint32_t node = state.currentNode;
+        if (state.runtimeAttribution && node == NO_NODE)
+        {
+            node = Simulator::GetContext();
+        }
+        header->size = size;
+        header->node = node;
+        header->layer = state.currentLayer;
+
+        LayerCounters& c = state.layers[header->layer];
+        c.liveBytes += size;
+        c.allocCount++;
+        if (c.liveBytes > c.peakBytes)
+        {
+            c.peakBytes = c.liveBytes;
+        }
+        if (node == NO_NODE)
+        {
+            state.noNodeBytes += size;
+        }
+        else
+        {
+            if (state.nodeBytes.size() <= node)
+            {
+                state.nodeBytes.resize(node + 1, 0);
+            }
+            state.nodeBytes[node] += size;
+        }
+        return header + 1;
+    }
+
+    /**
+     * Release a block allocated by Allocate().
+     * \param ptr The user pointer.
+     */
+    static void Release(void* ptr)
+    {
+        if (!ptr)
+        {
+            return;
+        }
+        auto* header = static_cast<BlockHeader*>(ptr) - 1;
+        auto& state = State();
+        state.layers[header->layer].liveBytes -= header->size;
+        if (header->node == NO_NODE)
+        {
+            state.noNodeBytes -= header->size;
+        }
+        else if (header->node < state.nodeBytes.size())
+        {
+            state.nodeBytes[header->node] -= header->size;
+        }
+        if (!MemoryPool::Release(header))
+        {
+            std::free(header);
+        }
+    }
+
+    /// \endcond
+};
+
+} // namespace ns3
+
+#ifdef MEMORY_ACCOUNTING
+
+void*
+operator new(std::size_t size)
+{
+    void* p = ns3::MemoryAccounting::Allocate(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    void* p = ns3::MemoryAccounting::Allocate(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ns3::MemoryAccounting::Allocate(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return ns3::MemoryAccounting::Allocate(size);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    ns3::MemoryAccounting::Release(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    ns3::MemoryAccounting::Release(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    ns3::MemoryAccounting::Release(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept
+{
+    ns3::MemoryAccounting::Release(ptr);
+}
+
+#endif // MEMORY_ACCOUNTING
+
+#endif // MEMORY_ACCOUNTING_H
@@ -0,0 +1,273 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+/*
+ * Size class pool behind the global operator new/delete.
+ *
+ * Built with -DMEMORY_POOL, this header replaces the global operator
+ * new/delete, so it must then be included by exactly one translation unit of
+ * a program (a scratch scenario is a single translation unit). Built with
+ * -DMEMORY_ACCOUNTING, memory-accounting.h replaces them instead and takes
+ * its blocks from this pool, headers included. Without either flag nothing
+ * is replaced and the pool cannot be enabled (HOOKED is false).
+ *
+ * MemoryPool::Enable() reserves one address range, split into one region per
+ * 16 byte size class up to 1 KiB. A block is carved from the region of its
+ * class, or taken back from the free list of the class, and its address
+ * gives its class on release: pooled blocks carry no header. It is a generic
+ * allocator for every small block of the program (objects, packets, headers,
+ * control messages alike), not a pool of one type. Larger blocks, those
+ * allocated before Enable() and those of the other threads go to malloc.
+ *
+ * After MemoryPool::BeginTeardown(), a pooled block released by
+ * Simulator::Destroy() is dropped instead of being pushed on its free list;
+ * the destructors still run, only the free itself is skipped, and the range
+ * goes back to the system when the process exits.
+ */
+
+#include <ns3/core-module.h>
+
+#include <cstdlib>
+#include <new>
+#include <pthread.h>
+#include <sys/mman.h>
+
+namespace ns3
+{
+
+/**
+ * Size class pool, with its counters.
+ */
+class MemoryPool
+{
+  public:
+#if defined(MEMORY_POOL) || defined(MEMORY_ACCOUNTING)
+    /// Whether operator new/delete go through the pool once it is enabled
+    static constexpr bool HOOKED = true;
+#else
+    /// Whether operator new/delete go through the pool once it is enabled
+    static constexpr bool HOOKED = false;
+#endif
+
+    /// Size class granularity, in bytes
+    static constexpr size_t GRANULARITY = 16;
+
+    /// Largest block served, larger ones use malloc
+    static constexpr size_t MAX_BLOCK = 1024;
+
+    /// Number of size classes
+    static constexpr size_t CLASSES = MAX_BLOCK / GRANULARITY;
+
+    /**
+     * Serve the blocks up to MAX_BLOCK bytes of the calling thread from the
+     * pool. To be called once, as early as possible.
+     *
+     * \param reserve Address range reserved for the pool, in bytes, split
+     *                evenly between the size classes. Only the pages actually
+     *                used are backed by memory; once the region of a class is
+     *                full, its allocations go back to malloc.
+     */
+    static void Enable(size_t reserve = size_t(64) << 30)
+    {
+        PoolState& state = State();
+        NS_ABORT_MSG_IF(state.base, "The memory pool is already enabled");
+        size_t regionSize = reserve / CLASSES / GRANULARITY * GRANULARITY;
+        NS_ABORT_MSG_IF(regionSize < MAX_BLOCK, "A pool of " << reserve << " bytes is too small");
+        void* base = mmap(nullptr,
+                          regionSize * CLASSES,
+                          PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                          -1,
+                          0);
+        NS_ABORT_MSG_IF(base == MAP_FAILED, "Cannot reserve " << reserve << " bytes for the pool");
+        state.owner = pthread_self();
+        state.regionSize = regionSize;
+        state.end = static_cast<char*>(base) + regionSize * CLASSES;
+        for (size_t c = 0; c < CLASSES; c++)
+        {
+            state.top[c] = static_cast<char*>(base) + c * regionSize;
+        }
+        state.base = static_cast<char*>(base);
+    }
+
+    /**
+     * Stop recycling pooled blocks, before Simulator::Destroy(): their
+     * release then only checks the block address.
+     */
+    static void BeginTeardown()
+    {
+        State().teardown = true;
+    }
+
+    /**
+     * Print the bytes carved, those in the free lists and the blocks reused.
+     * \param os The output stream.
+     */
+    static void Print(std::ostream& os)
+    {
+        const PoolState& state = State();
+        if (!state.base)
+        {
+            return;
+        }
+        size_t carved = 0;
+        for (size_t c = 0; c < CLASSES; c++)
+        {
+            carved += state.top[c] - (state.base + c * state.regionSize);
+        }
+        os << "  pool: " << carved / 1024 << " KiB carved, " << state.freeBytes / 1024
+           << " KiB in the free lists, " << state.reuses << " blocks reused" << std::endl;
+    }
+
+    /// \cond PRIVATE
+    /**
+     * Take a block from the pool.
+     * \param size Block size.
+     * \return The block, nullptr if the pool does not serve it.
+     */
+    static void* Allocate(size_t size)
+    {
+        PoolState& state = State();
+        if (!state.base || size > MAX_BLOCK || !pthread_equal(pthread_self(), state.owner))
+        {
+            return nullptr;
+        }
+        size_t c = size == 0 ? 0 : (size - 1) / GRANULARITY;
+        void* p = state.freeLists[c];
+        if (p)
+        {
+            state.freeLists[c] = *static_cast<void**>(p);
+            state.freeBytes -= (c + 1) * GRANULARITY;
+            state.reuses++;
+            return p;
+        }
+        size_t classSize = (c + 1) * GRANULARITY;
+        if (state.top[c] + classSize > state.base + (c + 1) * state.regionSize)
+        {
+            return nullptr;
+        }
+        p = state.top[c];
+        state.top[c] += classSize;
+        return p;
+    }
+
+    /**
+     * Give a block back to the pool if it comes from there.
+     * \param p The block.
+     * \return False if the block is not from the pool, to be freed by malloc.
+     */
+    static bool Release(void* p)
+    {
+        PoolState& state = State();
+        char* block = static_cast<char*>(p);
+        if (block < state.base || block >= state.end)
+        {
+            return false;
+        }
+        // Blocks released by the other threads are not recycled
+        if (state.teardown || !pthread_equal(pthread_self(), state.owner))
+        {
+            return true;
+        }
+        size_t c = (block - state.base) / state.regionSize;
+        *static_cast<void**>(p) = state.freeLists[c];
+        state.freeLists[c] = p;
+        state.freeBytes += (c + 1) * GRANULARITY;
+        return true;
+    }
+
+  private:
+    /// Pool state, zero initialized before the first allocation of the program
+    struct PoolState
+    {
+        char* base;               //!< Range start, null until Enable()
+        char* end;                //!< Range end
+        size_t regionSize;        //!< Bytes reserved per size class
+        char* top[CLASSES];       //!< First never used byte of each region
+        void* freeLists[CLASSES]; //!< Free blocks per class
+        int64_t freeBytes;        //!< Bytes in the free lists
+        uint64_t reuses;          //!< Blocks taken from a list
+        pthread_t owner;          //!< Thread served by the pool
+        bool teardown;            //!< Set by BeginTeardown()
+    };
+
+    /**
+     * \return The pool state, a trivial static that needs no construction.
+     */
+    static PoolState& State()
+    {
+        static PoolState state;
+        return state;
+    }
+
+    /// \endcond
+};
+
+} // namespace ns3
+
+#if defined(MEMORY_POOL) && !defined(MEMORY_ACCOUNTING)
+
+void*
+operator new(std::size_t size)
+{
+    void* p = ns3::MemoryPool::Allocate(size);
+    if (!p)
+    {
+        p = std::malloc(size);
+    }
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void*
+operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    void* p = ns3::MemoryPool::Allocate(size);
+    return p ? p : std::malloc(size);
+}
+
+void*
+operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    if (!ns3::MemoryPool::Release(ptr))
+    {
+        std::free(ptr);
+    }
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void
+operator delete[](void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+#endif // MEMORY_POOL && !MEMORY_ACCOUNTING
+
+#endif // MEMORY_POOL_H
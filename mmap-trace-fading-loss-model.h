@@ -0,0 +1,299 @@
+#ifndef MMAP_TRACE_FADING_LOSS_MODEL_H
+#define MMAP_TRACE_FADING_LOSS_MODEL_H
+
+#include <ns3/core-module.h>
+#include <ns3/mobility-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-value.h>
+
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * Header of the binary fading trace format read by MmapTraceFadingLossModel.
+ *
+ * The header is followed by samplesNum rows of rbNum float values, each value
+ * being the linear fading gain of one RB at one sample. Storing a whole sample
+ * row contiguously lets a single TTI lookup touch one cache line per 16 RBs.
+ */
+struct MmapFadingTraceHeader
+{
+    char magic[8];       //!< "LTEFADB1"
+    uint32_t version;    //!< Format version, currently 1
+    uint32_t rbNum;      //!< Number of RBs per sample
+    uint32_t samplesNum; //!< Number of samples in the trace
+    uint32_t reserved;   //!< Padding, always 0
+    double traceLength;  //!< Trace duration in seconds
+};
+
+/**
+ * Fading loss model reading a binary trace through a read-only shared memory
+ * mapping.
+ *
+ * It follows the windowing of TraceFadingLossModel (one random window offset
+ * per link, redrawn every WindowSize), but the trace is never copied into the
+ * heap: every process mapping the same file shares the same physical pages,
+ * and a lookup is a pointer offset into the mapping.
+ */
+class MmapTraceFadingLossModel : public SpectrumPropagationLossModel
+{
+  public:
+    MmapTraceFadingLossModel()
+        : m_base(nullptr),
+          m_mapLength(0),
+          m_rbNum(0),
+          m_samplesNum(0),
+          m_windowSamples(0),
+          m_timeGranularity(1.0),
+          m_lastWindowUpdate(Seconds(0))
+    {
+        m_startVariable = CreateObject<UniformRandomVariable>();
+    }
+
+    ~MmapTraceFadingLossModel() override
+    {
+        UnmapTrace();
+    }
+
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::MmapTraceFadingLossModel")
+                .SetParent<SpectrumPropagationLossModel>()
+                .AddConstructor<MmapTraceFadingLossModel>()
+                .AddAttribute("TraceFilename",
+                              "Name of the binary fading trace file to map",
+                              StringValue(""),
+                              MakeStringAccessor(&MmapTraceFadingLossModel::m_traceFile),
+                              MakeStringChecker())
+                .AddAttribute("WindowSize",
+                              "The size of the window for the fading trace",
+                              TimeValue(Seconds(0.5)),
+                              MakeTimeAccessor(&MmapTraceFadingLossModel::m_windowSize),
+                              MakeTimeChecker());
+        return tid;
+    }
+
+    /**
+     * Convert a text trace as distributed with the ns-3 LTE module (RbNum rows
+     * of SamplesNum dB values) into the binary format of this model.
+     *
+     * \param textFile Input trace in TraceFadingLossModel format.
+     * \param binFile Output binary trace.
+     * \param rbNum Number of RBs in the input trace.
+     * \param samplesNum Number of samples per RB in the input trace.
+     * \param traceLength Duration covered by the input trace.
+     */
+    static void ConvertTextTrace(const std::string& textFile,
+                                 const std::string& binFile,
+                                 uint32_t rbNum,
+                                 uint32_t samplesNum,
+                                 Time traceLength)
+    {
+        std::ifstream in(textFile);
+        NS_ABORT_MSG_IF(!in.good(), "Fading trace " << textFile << " not found");
+
+        // The text trace is RB-major, the binary one is sample-major
+        std::vector<float> gains(static_cast<size_t>(rbNum) * samplesNum);
+        for (uint32_t rb = 0; rb < rbNum; rb++)
+        {
+            for (uint32_t s = 0; s < samplesNum; s++)
+            {
+                double fadingDb;
+                in >> fadingDb;
+                NS_ABORT_MSG_IF(in.fail(), "Fading trace " << textFile << " is truncated");
+                gains[static_cast<size_t>(s) * rbNum + rb] =
+                    static_cast<float>(std::pow(10.0, fadingDb / 10.0));
+            }
+        }
+
+        MmapFadingTraceHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "LTEFADB1", sizeof(header.magic));
+        header.version = 1;
+        header.rbNum = rbNum;
+        header.samplesNum = samplesNum;
+        header.traceLength = traceLength.GetSeconds();
+
+        std::ofstream out(binFile, std::ios::binary | std::ios::trunc);
+        NS_ABORT_MSG_IF(!out.good(), "Cannot write " << binFile);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(gains.data()), gains.size() * sizeof(float));
+    }
+
+  protected:
+    void DoInitialize() override
+    {
+        MapTrace();
+        SpectrumPropagationLossModel::DoInitialize();
+    }
+
+    void DoDispose() override
+    {
+        m_offsets.clear();
+        m_startVariable = nullptr;
+        UnmapTrace();
+        SpectrumPropagationLossModel::DoDispose();
+    }
+
+  private:
+    /// Hash of a (tx, rx) mobility pair identifying one link
+    struct LinkHash
+    {
+        size_t operator()(
+            const std::pair<Ptr<const MobilityModel>, Ptr<const MobilityModel>>& link) const
+        {
+            return std::hash<const MobilityModel*>()(PeekPointer(link.first)) * 31 +
+                   std::hash<const MobilityModel*>()(PeekPointer(link.second));
+        }
+    };
+
+    Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity(Ptr<const SpectrumSignalParameters> params,
+                                                    Ptr<const MobilityModel> a,
+                                                    Ptr<const MobilityModel> b) const override
+    {
+        if (!m_base)
+        {
+            const_cast<MmapTraceFadingLossModel*>(this)->MapTrace();
+        }
+
+        Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue>(params->psd);
+
+        auto link = std::make_pair(a, b);
+        auto it = m_offsets.find(link);
+        if (it == m_offsets.end())
+        {
+            it = m_offsets.emplace(link, DrawOffset()).first;
+        }
+
+        Time now = Simulator::Now();
+        if (now >= m_lastWindowUpdate + m_windowSize)
+        {
+            for (auto& offset : m_offsets)
+            {
+                offset.second = DrawOffset();
+            }
+            m_lastWindowUpdate = now;
+        }
+
+        auto nowSample = static_cast<uint64_t>(now.GetMilliSeconds() * m_timeGranularity);
+        auto lastUpdateSample =
+            static_cast<uint64_t>(m_lastWindowUpdate.GetMilliSeconds() * m_timeGranularity);
+        uint64_t index = (it->second + nowSample - lastUpdateSample) % m_samplesNum;
+
+        const float* row = m_base + index * m_rbNum;
+        uint32_t rb = 0;
+        for (auto vit = rxPsd->ValuesBegin(); vit != rxPsd->ValuesEnd() && rb < m_rbNum;
+             ++vit, ++rb)
+        {
+            *vit *= row[rb];
+        }
+        return rxPsd;
+    }
+
+    int64_t DoAssignStreams(int64_t stream) override
+    {
+        m_startVariable->SetStream(stream);
+        return 1;
+    }
+
+    /**
+     * Draw a new window start for a link, in trace samples.
+     * \return The window offset.
+     */
+    uint64_t DrawOffset() const
+    {
+        return m_startVariable->GetInteger(0, m_samplesNum - m_windowSamples - 1);
+    }
+
+    /// Map the trace file read-only and validate its header
+    void MapTrace()
+    {
+        if (m_base)
+        {
+            return;
+        }
+        NS_ABORT_MSG_IF(m_traceFile.empty(), "MmapTraceFadingLossModel needs a TraceFilename");
+
+        int fd = open(m_traceFile.c_str(), O_RDONLY);
+        NS_ABORT_MSG_IF(fd < 0, "Cannot open fading trace " << m_traceFile);
+        struct stat st;
+        NS_ABORT_MSG_IF(fstat(fd, &st) != 0, "Cannot stat fading trace " << m_traceFile);
+        m_mapLength = static_cast<size_t>(st.st_size);
+        NS_ABORT_MSG_IF(m_mapLength < sizeof(MmapFadingTraceHeader),
+                        "Fading trace " << m_traceFile << " is too short");
+
+        // MAP_SHARED on a read-only file: all processes share the page cache copy
+        void* addr = mmap(nullptr, m_mapLength, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        NS_ABORT_MSG_IF(addr == MAP_FAILED, "Cannot map fading trace " << m_traceFile);
+
+        const auto* header = static_cast<const MmapFadingTraceHeader*>(addr);
+        NS_ABORT_MSG_IF(std::memcmp(header->magic, "LTEFADB1", sizeof(header->magic)) != 0 ||
+                            header->version != 1,
+                        m_traceFile << " is not a binary fading trace");
+        m_rbNum = header->rbNum;
+        m_samplesNum = header->samplesNum;
+        NS_ABORT_MSG_IF(m_mapLength < sizeof(MmapFadingTraceHeader) +
+                                          static_cast<size_t>(m_rbNum) * m_samplesNum *
+                                              sizeof(float),
+                        "Fading trace " << m_traceFile << " is truncated");
+
+        m_base = reinterpret_cast<const float*>(static_cast<const char*>(addr) +
+                                                sizeof(MmapFadingTraceHeader));
+        m_timeGranularity = m_samplesNum / (header->traceLength * 1000.0);
+        m_windowSamples = static_cast<uint64_t>(m_windowSize.GetMilliSeconds() * m_timeGranularity);
+        NS_ABORT_MSG_IF(m_windowSamples >= m_samplesNum,
+                        "WindowSize is longer than the fading trace");
+        madvise(addr, m_mapLength, MADV_RANDOM);
+    }
+
+    /// Release the mapping, if any
+    void UnmapTrace()
+    {
+        if (m_base)
+        {
+            munmap(const_cast<char*>(reinterpret_cast<const char*>(m_base) -
+                                     sizeof(MmapFadingTraceHeader)),
+                   m_mapLength);
+            m_base = nullptr;
+        }
+    }
+
+    std::string m_traceFile;  //!< Binary trace file name
+    Time m_windowSize;        //!< Window size
+    const float* m_base;      //!< First sample of the mapped trace
+    size_t m_mapLength;       //!< Length of the mapping in bytes
+    uint32_t m_rbNum;         //!< RBs per sample
+    uint32_t m_samplesNum;    //!< Samples in the trace
+    uint64_t m_windowSamples; //!< Window size in samples
+    double m_timeGranularity; //!< Samples per millisecond
+
+    /// Window offset of each link, in samples
+    mutable std::unordered_map<std::pair<Ptr<const MobilityModel>, Ptr<const MobilityModel>>,
+                               uint64_t,
+                               LinkHash>
+        m_offsets;
+    mutable Time m_lastWindowUpdate;            //!< Time of the last window update
+    Ptr<UniformRandomVariable> m_startVariable; //!< Window offset generator
+};
+
+NS_OBJECT_ENSURE_REGISTERED(MmapTraceFadingLossModel);
+
+} // namespace ns3
+
+#endif // MMAP_TRACE_FADING_LOSS_MODEL_H
@@ -0,0 +1,336 @@
+#ifndef PCAP_RING_CAPTURE_H
+#define PCAP_RING_CAPTURE_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+#include <ns3/network-module.h>
+#include <ns3/point-to-point-module.h>
+
+#include <deque>
+#include <memory>
+
+namespace ns3
+{
+
+/**
+ * Packet capture of point-to-point links kept in memory, and written to
+ * pcap files only when a trigger fires.
+ *
+ * Each link keeps the packets it carried, in both directions, in a ring
+ * holding the last bytesPerLink bytes of packets. A packet is taken from the
+ * PhyTxBegin trace of the device sending it, as the channel hands the
+ * receiver a copy: the ring holds a reference to the transmitted packet,
+ * which nothing modifies afterwards, so the steady-state cost is a deque
+ * push and pop per packet, without allocation or I/O. Both directions are
+ * thus stamped with their transmission start, where a pcap of the receiving
+ * device would show the arrival. A trigger, from Trigger(), the
+ * UE radio link failures, the eNB handover failures or a throughput drop,
+ * schedules a dump PostTriggerTime later, so that the files also hold what
+ * followed it: one <prefix>-<n>-<link>.pcap file per link (PPP link type,
+ * as PointToPointHelper::EnablePcap writes them). The triggers coming before
+ * the dump join it, and those within HoldoffTime after a dump are counted
+ * but ignored, so that a burst of failures makes one dump.
+ */
+class PcapRingCapture
+{
+  public:
+    /**
+     * \param prefix Prefix of the pcap files.
+     * \param bytesPerLink Packet bytes kept per link.
+     */
+    PcapRingCapture(const std::string& prefix, uint64_t bytesPerLink)
+        : m_prefix(prefix),
+          m_bytesPerLink(bytesPerLink),
+          m_postTrigger(MilliSeconds(50)),
+          m_holdoff(Seconds(1)),
+          m_holdoffEnd(Seconds(0)),
+          m_thresholdMbps(0),
+          m_log(nullptr),
+          m_dumps(0),
+          m_ignored(0)
+    {
+    }
+
+    /**
+     * \param postTrigger Capture time after a trigger, before the dump.
+     */
+    void SetPostTriggerTime(Time postTrigger)
+    {
+        m_postTrigger = postTrigger;
+    }
+
+    /**
+     * \param holdoff Time after a dump during which the triggers are ignored.
+     */
+    void SetHoldoffTime(Time holdoff)
+    {
+        m_holdoff = holdoff;
+    }
+
+    /**
+     * \param log Stream to report the dumps to, nullptr for none.
+     */
+    void SetLog(std::ostream* log)
+    {
+        m_log = log;
+    }
+
+    /**
+     * Capture a link.
+     *
+     * \param name Name of the link in the file names.
+     * \param device The device of one end of the link.
+     */
+    void AddLink(const std::string& name, Ptr<PointToPointNetDevice> device)
+    {
+        NS_ABORT_MSG_IF(!device, "No point-to-point device for link " << name);
+        m_links.push_back(std::make_unique<Link>(name, m_bytesPerLink));
+        Link* link = m_links.back().get();
+        Ptr<Channel> channel = device->GetChannel();
+        for (std::size_t j = 0; j < channel->GetNDevices(); j++)
+        {
+            // Direction 0 is sent by device, 1 by its peer
+            Ptr<NetDevice> end = channel->GetDevice(j);
+            uint32_t direction = end == device ? 0 : 1;
+            link->fromNode[direction] = end->GetNode()->GetId();
+            end->TraceConnectWithoutContext("PhyTxBegin",
+                                            MakeBoundCallback(&Link::Transmit, link, direction));
+        }
+    }
+
+    /**
+     * \param node A node.
+     * \param peer Another node.
+     * \return The point-to-point device of node linked to peer, null if none.
+     */
+    static Ptr<PointToPointNetDevice> FindLink(Ptr<Node> node, Ptr<Node> peer)
+    {
+        for (uint32_t i = 0; i < node->GetNDevices(); i++)
+        {
+            Ptr<PointToPointNetDevice> device =
+                DynamicCast<PointToPointNetDevice>(node->GetDevice(i));
+            if (!device)
+            {
+                continue;
+            }
+            Ptr<Channel> channel = device->GetChannel();
+            for (std::size_t j = 0; j < channel->GetNDevices(); j++)
+            {
+                if (channel->GetDevice(j)->GetNode() == peer)
+                {
+                    return device;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * Trigger on the radio link failures of the UEs and on the handover
+     * failures of the eNBs. To be called after the LTE devices are installed.
+     */
+    void InstallLteTriggers()
+    {
+        Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/LteUeRrc/RadioLinkFailure",
+                                      MakeCallback(&PcapRingCapture::RadioLinkFailure, this));
+        for (const char* failure : {"NoPreamble", "MaxRach", "Leaving", "Joining"})
+        {
+            Config::ConnectWithoutContext(
+                std::string("/NodeList/*/DeviceList/*/LteEnbRrc/HandoverFailure") + failure,
+                MakeCallback(&PcapRingCapture::HandoverFailure, this));
+        }
+    }
+
+    /**
+     * Trigger when the throughput of a link in one direction falls below a
+     * threshold after having been above it. The directions are measured
+     * separately, so a stalled direction is caught even when the other one
+     * keeps the sum up.
+     *
+     * \param thresholdMbps The threshold, in Mb/s.
+     * \param interval The interval the throughput is measured over.
+     */
+    void SetThroughputTrigger(double thresholdMbps, Time interval)
+    {
+        m_thresholdMbps = thresholdMbps;
+        m_throughputInterval = interval;
+        m_throughputEvent.Cancel();
+        m_throughputEvent =
+            Simulator::Schedule(interval, &PcapRingCapture::CheckThroughput, this);
+    }
+
+    /**
+     * Dump the rings of all links PostTriggerTime from now.
+     *
+     * \param reason The reason, reported in the log.
+     */
+    void Trigger(const std::string& reason)
+    {
+        if (m_dumpEvent.IsRunning())
+        {
+            m_reasons += ", " + reason;
+            return;
+        }
+        if (Simulator::Now() < m_holdoffEnd)
+        {
+            m_ignored++;
+            return;
+        }
+        m_reasons = reason;
+        m_dumpEvent = Simulator::Schedule(m_postTrigger, &PcapRingCapture::Dump, this);
+    }
+
+    /// Write the dump still waiting for its post-trigger capture, if any.
+    void Finish()
+    {
+        if (m_dumpEvent.IsRunning())
+        {
+            m_dumpEvent.Cancel();
+            Dump();
+        }
+        m_throughputEvent.Cancel();
+    }
+
+    /// \return The number of dumps written.
+    uint32_t GetDumps() const
+    {
+        return m_dumps;
+    }
+
+    /// \return The number of triggers ignored during the holdoff times.
+    uint32_t GetIgnoredTriggers() const
+    {
+        return m_ignored;
+    }
+
+  private:
+    /// Ring of the last packets of one link
+    struct Link
+    {
+        /**
+         * \param linkName Name of the link.
+         * \param linkCapacity Packet bytes kept.
+         */
+        Link(const std::string& linkName, uint64_t linkCapacity)
+            : name(linkName),
+              capacity(linkCapacity)
+        {
+        }
+
+        /**
+         * Keep a packet and drop the oldest ones beyond the capacity.
+         * \param link The link.
+         * \param direction The direction of the packet.
+         * \param packet A packet starting its transmission.
+         */
+        static void Transmit(Link* link, uint32_t direction, Ptr<const Packet> packet)
+        {
+            uint32_t size = packet->GetSize();
+            link->ring.emplace_back(Simulator::Now(), packet);
+            link->bytes += size;
+            link->intervalBytes[direction] += size;
+            while (link->bytes > link->capacity && link->ring.size() > 1)
+            {
+                link->bytes -= link->ring.front().second->GetSize();
+                link->ring.pop_front();
+            }
+        }
+
+        std::string name;                                    //!< Link name
+        uint64_t capacity;                                   //!< Packet bytes kept
+        std::deque<std::pair<Time, Ptr<const Packet>>> ring; //!< Capture time, packet
+        uint64_t bytes = 0;                                  //!< Packet bytes in the ring
+        uint32_t fromNode[2] = {0, 0};                       //!< Sending node, per direction
+        uint64_t intervalBytes[2] = {0, 0};                  //!< Bytes in this interval
+        bool aboveThreshold[2] = {false, false};             //!< Throughput last interval
+    };
+
+    /**
+     * \param imsi The IMSI of the UE.
+     * \param cellId The serving cell.
+     */
+    void RadioLinkFailure(uint64_t imsi, uint16_t cellId, uint16_t /* rnti */)
+    {
+        Trigger("RLF of IMSI " + std::to_string(imsi) + " in cell " + std::to_string(cellId));
+    }
+
+    /**
+     * \param imsi The IMSI of the UE.
+     * \param cellId The cell of the eNB reporting the failure.
+     */
+    void HandoverFailure(uint64_t imsi, uint16_t /* rnti */, uint16_t cellId)
+    {
+        Trigger("handover failure of IMSI " + std::to_string(imsi) + " in cell " +
+                std::to_string(cellId));
+    }
+
+    /// Check the throughput of each link over the last interval.
+    void CheckThroughput()
+    {
+        for (auto& link : m_links)
+        {
+            for (uint32_t d = 0; d < 2; d++)
+            {
+                double mbps =
+                    link->intervalBytes[d] * 8 / m_throughputInterval.GetSeconds() / 1e6;
+                link->intervalBytes[d] = 0;
+                if (link->aboveThreshold[d] && mbps < m_thresholdMbps)
+                {
+                    Trigger("throughput of " + link->name + " from node " +
+                            std::to_string(link->fromNode[d]) + " down to " +
+                            std::to_string(mbps) + " Mb/s");
+                }
+                link->aboveThreshold[d] = mbps >= m_thresholdMbps;
+            }
+        }
+        m_throughputEvent =
+            Simulator::Schedule(m_throughputInterval, &PcapRingCapture::CheckThroughput, this);
+    }
+
+    /// Write the ring of every link to its pcap file.
+    void Dump()
+    {
+        PcapHelper pcapHelper;
+        for (const auto& link : m_links)
+        {
+            if (link->ring.empty())
+            {
+                continue;
+            }
+            std::string fileName =
+                m_prefix + "-" + std::to_string(m_dumps) + "-" + link->name + ".pcap";
+            Ptr<PcapFileWrapper> file =
+                pcapHelper.CreateFile(fileName, std::ios::out, PcapHelper::DLT_PPP);
+            for (const auto& entry : link->ring)
+            {
+                file->Write(entry.first, entry.second);
+            }
+        }
+        if (m_log)
+        {
+            *m_log << Simulator::Now().As(Time::S) << " pcap ring dump " << m_prefix << "-"
+                   << m_dumps << "-*.pcap: " << m_reasons << std::endl;
+        }
+        m_dumps++;
+        m_holdoffEnd = Simulator::Now() + m_holdoff;
+    }
+
+    std::string m_prefix;                       //!< Prefix of the pcap files
+    uint64_t m_bytesPerLink;                    //!< Packet bytes kept per link
+    Time m_postTrigger;                         //!< Capture time after a trigger
+    Time m_holdoff;                             //!< Triggers ignored after a dump
+    Time m_holdoffEnd;                          //!< End of the current holdoff
+    double m_thresholdMbps;                     //!< Throughput trigger threshold
+    Time m_throughputInterval;                  //!< Throughput measurement interval
+    std::ostream* m_log;                        //!< Dump log, may be null
+    std::vector<std::unique_ptr<Link>> m_links; //!< Captured links
+    std::string m_reasons;                      //!< Triggers of the pending dump
+    EventId m_dumpEvent;                        //!< Pending dump
+    EventId m_throughputEvent;                  //!< Next throughput check
+    uint32_t m_dumps;                           //!< Dumps written
+    uint32_t m_ignored;                         //!< Triggers ignored in holdoff
+};
+
+} // namespace ns3
+
+#endif // PCAP_RING_CAPTURE_H
@@ -0,0 +1,297 @@
+#ifndef PROGRESS_SCHEDULER_H
+#define PROGRESS_SCHEDULER_H
+
+#include <ns3/core-module.h>
+#include <ns3/scheduler.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+namespace ns3
+{
+
+/**
+ * Event scheduler decorator reporting the progress of Simulator::Run().
+ *
+ * It forwards every call to the scheduler given by its Scheduler attribute
+ * and, every CheckEvents dequeued events, reads the wall clock. Once Interval
+ * of wall-clock time has passed it prints the simulation time, the speed
+ * (simulated seconds per wall second), the events per second, the number of
+ * pending events and, if StopTime is set, the ETA. Since no event is ever
+ * scheduled for the report, the event order and uids are those of a run
+ * without it.
+ *
+ * These reports only come between two events: a run stuck in one event
+ * prints nothing. For that case a watchdog thread checks the dequeued
+ * events every Interval, and once no event was dequeued for StallTime it
+ * prints, once per stall, the simulation time of the event still running.
+ * The event itself cannot be named, and a run that returned from
+ * Simulator::Run() before StopTime, e.g. on an early stop, looks stalled
+ * too until the simulator is destroyed.
+ *
+ * With LogFile set, every report is also appended as one line of
+ *
+ *   monotonic_ns wall_s sim_s events pending events_per_s speed
+ *
+ * where monotonic_ns is CLOCK_MONOTONIC, the clock perf uses for its sample
+ * timestamps, and sim_s matches the times of the memory reports. Enable it
+ * before the first use of the simulator with e.g.
+ *
+ *   Config::SetDefault("ns3::ProgressScheduler::Scheduler",
+ *                      StringValue("ns3::TtiCalendarScheduler"));
+ *   GlobalValue::Bind("SchedulerType", StringValue("ns3::ProgressScheduler"));
+ */
+class ProgressScheduler : public Scheduler
+{
+  public:
+    ProgressScheduler()
+        : m_events(0),
+          m_pending(0),
+          m_nextCheck(0),
+          m_lastTs(0),
+          m_lastEvents(0),
+          m_lastSimTime(0)
+    {
+    }
+
+    ~ProgressScheduler() override
+    {
+        if (m_watchdog.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_watchdogMutex);
+                m_watchdogStop = true;
+            }
+            m_watchdogWakeup.notify_one();
+            m_watchdog.join();
+        }
+    }
+
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::ProgressScheduler")
+                .SetParent<Scheduler>()
+                .AddConstructor<ProgressScheduler>()
+                .AddAttribute("Scheduler",
+                              "TypeId of the scheduler holding the events",
+                              StringValue("ns3::MapScheduler"),
+                              MakeStringAccessor(&ProgressScheduler::m_schedulerType),
+                              MakeStringChecker())
+                .AddAttribute("Interval",
+                              "Wall-clock time between two reports",
+                              TimeValue(Seconds(10)),
+                              MakeTimeAccessor(&ProgressScheduler::m_interval),
+                              MakeTimeChecker(MilliSeconds(1)))
+                .AddAttribute("StopTime",
+                              "Simulation time the run stops at, for the ETA, 0 if unknown",
+                              TimeValue(Seconds(0)),
+                              MakeTimeAccessor(&ProgressScheduler::m_stopTime),
+                              MakeTimeChecker())
+                .AddAttribute("CheckEvents",
+                              "Events dequeued between two reads of the wall clock",
+                              UintegerValue(1024),
+                              MakeUintegerAccessor(&ProgressScheduler::m_checkEvents),
+                              MakeUintegerChecker<uint32_t>(1))
+                .AddAttribute("LogFile",
+                              "File the reports are appended to, empty for none",
+                              StringValue(""),
+                              MakeStringAccessor(&ProgressScheduler::m_logFile),
+                              MakeStringChecker())
+                .AddAttribute("StallTime",
+                              "Wall-clock time without a dequeued event after which the "
+                              "watchdog reports the event still running, 0 for no watchdog",
+                              TimeValue(Seconds(60)),
+                              MakeTimeAccessor(&ProgressScheduler::m_stallTime),
+                              MakeTimeChecker());
+        return tid;
+    }
+
+    void Insert(const Event& ev) override
+    {
+        m_scheduler->Insert(ev);
+        m_pending++;
+    }
+
+    bool IsEmpty() const override
+    {
+        return m_scheduler->IsEmpty();
+    }
+
+    Event PeekNext() const override
+    {
+        return m_scheduler->PeekNext();
+    }
+
+    Event RemoveNext() override
+    {
+        Event ev = m_scheduler->RemoveNext();
+        m_pending--;
+        m_lastTs = ev.key.m_ts;
+        // Single writer: plain stores, no read-modify-write
+        m_watchTs.store(m_lastTs, std::memory_order_relaxed);
+        m_watchEvents.store(m_events + 1, std::memory_order_relaxed);
+        if (++m_events >= m_nextCheck)
+        {
+            m_nextCheck = m_events + m_checkEvents;
+            Clock::time_point now = Clock::now();
+            if (now - m_lastReport >= std::chrono::nanoseconds(m_interval.GetNanoSeconds()))
+            {
+                Report(now);
+            }
+        }
+        return ev;
+    }
+
+    void Remove(const Event& ev) override
+    {
+        m_scheduler->Remove(ev);
+        m_pending--;
+    }
+
+  protected:
+    void NotifyConstructionCompleted() override
+    {
+        Scheduler::NotifyConstructionCompleted();
+        ObjectFactory factory(m_schedulerType);
+        m_scheduler = factory.Create<Scheduler>();
+        NS_ABORT_MSG_IF(!m_scheduler, m_schedulerType << " is not a scheduler");
+        m_start = Clock::now();
+        m_lastReport = m_start;
+        if (!m_logFile.empty())
+        {
+            m_log.open(m_logFile, std::ofstream::out | std::ofstream::app);
+            NS_ABORT_MSG_IF(!m_log.is_open(), "Cannot open " << m_logFile);
+        }
+        if (m_stallTime.IsStrictlyPositive())
+        {
+            m_watchdog = std::thread(&ProgressScheduler::Watch, this);
+        }
+    }
+
+  private:
+    /// Same clock as CLOCK_MONOTONIC on Linux
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Print a report and append it to the log.
+     * \param now The wall-clock time.
+     */
+    void Report(Clock::time_point now)
+    {
+        double wall = std::chrono::duration<double>(now - m_start).count();
+        double elapsed = std::chrono::duration<double>(now - m_lastReport).count();
+        double simTime = TimeStep(m_lastTs).GetSeconds();
+        double eventRate = elapsed > 0 ? (m_events - m_lastEvents) / elapsed : 0;
+        double speed = elapsed > 0 ? (simTime - m_lastSimTime) / elapsed : 0;
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1) << "[progress] wall " << wall << " s  sim "
+             << std::setprecision(3) << simTime << " s";
+        if (m_stopTime.IsStrictlyPositive())
+        {
+            line << " / " << m_stopTime.GetSeconds() << " s (" << std::setprecision(1)
+                 << 100 * simTime / m_stopTime.GetSeconds() << "%)";
+        }
+        line << "  speed " << std::setprecision(3) << speed << "x  " << std::setprecision(0)
+             << eventRate << " ev/s  pending " << m_pending;
+        if (m_stopTime.IsStrictlyPositive() && speed > 0)
+        {
+            double eta = (m_stopTime.GetSeconds() - simTime) / speed;
+            line << "  ETA " << static_cast<uint64_t>(eta) / 60 << "m"
+                 << static_cast<uint64_t>(eta) % 60 << "s";
+        }
+        std::cout << line.str() << std::endl;
+
+        if (m_log.is_open())
+        {
+            m_log << std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch())
+                         .count()
+                  << " " << std::setprecision(3) << std::fixed << wall << " " << simTime << " "
+                  << m_events << " " << m_pending << " " << std::setprecision(0) << eventRate
+                  << " " << std::setprecision(4) << speed << std::endl;
+        }
+
+        m_lastReport = now;
+        m_lastEvents = m_events;
+        m_lastSimTime = simTime;
+    }
+
+    /// Body of the watchdog thread: report the events that run for StallTime
+    void Watch()
+    {
+        auto interval = std::chrono::nanoseconds(m_interval.GetNanoSeconds());
+        auto stallTime = std::chrono::nanoseconds(m_stallTime.GetNanoSeconds());
+        uint64_t lastEvents = 0;
+        Clock::time_point lastChange = Clock::now();
+        bool reported = false;
+        std::unique_lock<std::mutex> lock(m_watchdogMutex);
+        while (!m_watchdogWakeup.wait_for(lock, interval, [this]() { return m_watchdogStop; }))
+        {
+            uint64_t events = m_watchEvents.load(std::memory_order_relaxed);
+            Clock::time_point now = Clock::now();
+            if (events != lastEvents)
+            {
+                lastEvents = events;
+                lastChange = now;
+                reported = false;
+                continue;
+            }
+            // Before the run, or after its stop event, nothing is running
+            double simTime = TimeStep(m_watchTs.load(std::memory_order_relaxed)).GetSeconds();
+            bool stopped = m_stopTime.IsStrictlyPositive() && simTime >= m_stopTime.GetSeconds();
+            if (events == 0 || stopped || reported || now - lastChange < stallTime)
+            {
+                continue;
+            }
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << "[progress] wall "
+                 << std::chrono::duration<double>(now - m_start).count()
+                 << " s  no event dequeued for "
+                 << std::chrono::duration<double>(now - lastChange).count()
+                 << " s, the event at sim " << std::setprecision(3) << simTime
+                 << " s is still running" << std::endl;
+            std::cout << line.str() << std::flush;
+            reported = true;
+        }
+    }
+
+    std::string m_schedulerType;    //!< TypeId of the wrapped scheduler
+    Time m_interval;                //!< Wall-clock report interval
+    Time m_stopTime;                //!< Stop time, for the ETA
+    uint32_t m_checkEvents;         //!< Events between two wall-clock reads
+    std::string m_logFile;          //!< Log file name
+    Time m_stallTime;               //!< Wall-clock time of a stalled event
+    Ptr<Scheduler> m_scheduler;     //!< Wrapped scheduler
+    std::ofstream m_log;            //!< Log file
+    uint64_t m_events;              //!< Events dequeued
+    uint64_t m_pending;             //!< Events queued
+    uint64_t m_nextCheck;           //!< Event count of the next wall-clock read
+    uint64_t m_lastTs;              //!< Timestamp of the last dequeued event
+    Clock::time_point m_start;      //!< Creation time
+    Clock::time_point m_lastReport; //!< Time of the last report
+    uint64_t m_lastEvents;          //!< Event count at the last report
+    double m_lastSimTime;           //!< Simulation time at the last report, in s
+
+    std::atomic<uint64_t> m_watchEvents{0};   //!< Events dequeued, for the watchdog
+    std::atomic<uint64_t> m_watchTs{0};       //!< Timestamp of the last dequeued event
+    std::thread m_watchdog;                   //!< Watchdog thread, if any
+    std::mutex m_watchdogMutex;               //!< Guards m_watchdogStop
+    std::condition_variable m_watchdogWakeup; //!< Wakes the watchdog up to stop
+    bool m_watchdogStop = false;              //!< Whether the watchdog must stop
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ProgressScheduler);
+
+} // namespace ns3
+
+#endif // PROGRESS_SCHEDULER_H
@@ -0,0 +1,848 @@
+#ifndef RECORDING_FF_MAC_SCHEDULER_H
+#define RECORDING_FF_MAC_SCHEDULER_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <variant>
+
+namespace ns3
+{
+
+/**
+ * Header of the binary scheduler input log written by RecordingFfMacScheduler.
+ *
+ * The header is followed by the records of one cell, in the order the
+ * scheduler received them: a FfMacLogRecord type byte, then the fields of the
+ * SAP parameters, integers as LEB128 varints and vectors as their size
+ * followed by their elements. A TTI with one trigger and a few CQIs takes a
+ * few tens of bytes.
+ */
+struct FfMacLogHeader
+{
+    char magic[8];     //!< "LTEFFMR1"
+    uint32_t version;  //!< Format version, currently 1
+    uint16_t cellId;   //!< Cell of the scheduler
+    uint16_t reserved; //!< Padding, always 0
+};
+
+/// Types of the records of a scheduler input log, one per SAP primitive
+enum FfMacLogRecord : uint8_t
+{
+    CSCHED_CELL_CONFIG = 1,
+    CSCHED_UE_CONFIG,
+    CSCHED_LC_CONFIG,
+    CSCHED_LC_RELEASE,
+    CSCHED_UE_RELEASE,
+    SCHED_DL_RLC_BUFFER,
+    SCHED_DL_TRIGGER,
+    SCHED_DL_RACH_INFO,
+    SCHED_DL_CQI_INFO,
+    SCHED_UL_TRIGGER,
+    SCHED_UL_MAC_CTRL_INFO,
+    SCHED_UL_CQI_INFO,
+};
+
+/**
+ * \defgroup ffmaclog Fields of the logged SAP parameters
+ *
+ * One function per parameter structure lists the fields the ns-3 eNB MAC
+ * fills, for FfMacLogWriter and FfMacLogReader alike, so that both sides of
+ * the format cannot drift apart.
+ * @{
+ */
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacCschedSapProvider::CschedCellConfigReqParameters& p)
+{
+    ar(p.m_ulBandwidth);
+    ar(p.m_dlBandwidth);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacCschedSapProvider::CschedUeConfigReqParameters& p)
+{
+    ar(p.m_rnti);
+    ar(p.m_transmissionMode);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param e The logical channel.
+ */
+template <class Archive>
+void Serialize(Archive& ar, LogicalChannelConfigListElement_s& e)
+{
+    ar(e.m_logicalChannelIdentity);
+    ar(e.m_logicalChannelGroup);
+    ar(e.m_direction);
+    ar(e.m_qosBearerType);
+    ar(e.m_qci);
+    ar(e.m_eRabMaximulBitrateUl);
+    ar(e.m_eRabMaximulBitrateDl);
+    ar(e.m_eRabGuaranteedBitrateUl);
+    ar(e.m_eRabGuaranteedBitrateDl);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacCschedSapProvider::CschedLcConfigReqParameters& p)
+{
+    ar(p.m_rnti);
+    ar(p.m_reconfigureFlag);
+    ar(p.m_logicalChannelConfigList);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacCschedSapProvider::CschedLcReleaseReqParameters& p)
+{
+    ar(p.m_rnti);
+    ar(p.m_logicalChannelIdentity);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacCschedSapProvider::CschedUeReleaseReqParameters& p)
+{
+    ar(p.m_rnti);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& p)
+{
+    ar(p.m_rnti);
+    ar(p.m_logicalChannelIdentity);
+    ar(p.m_rlcTransmissionQueueSize);
+    ar(p.m_rlcTransmissionQueueHolDelay);
+    ar(p.m_rlcRetransmissionQueueSize);
+    ar(p.m_rlcRetransmissionHolDelay);
+    ar(p.m_rlcStatusPduSize);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param e The HARQ feedback of one UE.
+ */
+template <class Archive>
+void Serialize(Archive& ar, DlInfoListElement_s& e)
+{
+    ar(e.m_rnti);
+    ar(e.m_harqProcessId);
+    ar(e.m_harqStatus);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacSchedSapProvider::SchedDlTriggerReqParameters& p)
+{
+    ar(p.m_sfnSf);
+    ar(p.m_dlInfoList);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param e The RACH preamble of one UE.
+ */
+template <class Archive>
+void Serialize(Archive& ar, RachListElement_s& e)
+{
+    ar(e.m_rnti);
+    ar(e.m_estimatedSize);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacSchedSapProvider::SchedDlRachInfoReqParameters& p)
+{
+    ar(p.m_sfnSf);
+    ar(p.m_rachList);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param e The CQI of one subband.
+ */
+template <class Archive>
+void Serialize(Archive& ar, HigherLayerSelected_s& e)
+{
+    ar(e.m_sbPmi);
+    ar(e.m_sbCqi);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param e The CQI report of one UE, wideband or subband (A30).
+ */
+template <class Archive>
+void Serialize(Archive& ar, CqiListElement_s& e)
+{
+    ar(e.m_rnti);
+    ar(e.m_ri);
+    ar(e.m_cqiType);
+    ar(e.m_wbCqi);
+    ar(e.m_wbPmi);
+    ar(e.m_sbMeasResult.m_higherLayerSelected);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& p)
+{
+    ar(p.m_sfnSf);
+    ar(p.m_cqiList);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param e The UL reception status of one UE.
+ */
+template <class Archive>
+void Serialize(Archive& ar, UlInfoListElement_s& e)
+{
+    ar(e.m_rnti);
+    ar(e.m_ulReception);
+    ar(e.m_receptionStatus);
+    ar(e.m_tpc);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacSchedSapProvider::SchedUlTriggerReqParameters& p)
+{
+    ar(p.m_sfnSf);
+    ar(p.m_ulInfoList);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param e The MAC control element (BSR, PHR) of one UE.
+ */
+template <class Archive>
+void Serialize(Archive& ar, MacCeListElement_s& e)
+{
+    ar(e.m_rnti);
+    ar(e.m_macCeType);
+    ar(e.m_macCeValue.m_phr);
+    ar(e.m_macCeValue.m_crnti);
+    ar(e.m_macCeValue.m_bufferStatus);
+}
+
+/**
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& p)
+{
+    ar(p.m_sfnSf);
+    ar(p.m_macCeList);
+}
+
+/**
+ * The RNTI of an SRS report travels in a vendor specific element, logged as
+ * a plain RNTI, 0 for the PUSCH reports.
+ *
+ * \param ar The writer or reader.
+ * \param p The parameters.
+ */
+template <class Archive>
+void Serialize(Archive& ar, FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& p)
+{
+    ar(p.m_sfnSf);
+    ar(p.m_ulCqi.m_sinr);
+    ar(p.m_ulCqi.m_type);
+    uint16_t srsRnti = 0;
+    for (const auto& vsp : p.m_vendorSpecificList)
+    {
+        if (vsp.m_type == SRS_CQI_RNTI_VSP)
+        {
+            srsRnti = DynamicCast<SrsCqiRntiVsp>(vsp.m_value)->GetRnti();
+        }
+    }
+    ar(srsRnti);
+    if (srsRnti != 0 && p.m_vendorSpecificList.empty())
+    {
+        VendorSpecificListElement_s vsp;
+        vsp.m_type = SRS_CQI_RNTI_VSP;
+        vsp.m_length = sizeof(SrsCqiRntiVsp);
+        vsp.m_value = Create<SrsCqiRntiVsp>(srsRnti);
+        p.m_vendorSpecificList.push_back(vsp);
+    }
+}
+
+/** @} */
+
+/**
+ * Appends the records of a scheduler input log to a buffer.
+ */
+class FfMacLogWriter
+{
+  public:
+    /**
+     * \param out The buffer the encoded fields are appended to.
+     */
+    explicit FfMacLogWriter(std::string& out)
+        : m_out(out)
+    {
+    }
+
+    /**
+     * Append one record.
+     *
+     * \param type The record type.
+     * \param params The SAP parameters.
+     */
+    template <class T>
+    void Record(FfMacLogRecord type, const T& params)
+    {
+        m_out.push_back(static_cast<char>(type));
+        (*this)(params);
+    }
+
+    /**
+     * Append a field.
+     * \param value An integer, an enum or a parameter structure.
+     */
+    template <class T>
+    void operator()(const T& value)
+    {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            PutVarint(static_cast<uint64_t>(value));
+        }
+        else
+        {
+            // Serialize only reads the fields when writing
+            Serialize(*this, const_cast<T&>(value));
+        }
+    }
+
+    /**
+     * Append a vector field.
+     * \param values The elements.
+     */
+    template <class T>
+    void operator()(const std::vector<T>& values)
+    {
+        PutVarint(values.size());
+        for (const auto& value : values)
+        {
+            (*this)(value);
+        }
+    }
+
+  private:
+    /**
+     * \param value The value to append as a LEB128 varint.
+     */
+    void PutVarint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            m_out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        m_out.push_back(static_cast<char>(value));
+    }
+
+    std::string& m_out; //!< Output buffer
+};
+
+/**
+ * Decodes a whole scheduler input log.
+ */
+class FfMacLogReader
+{
+  public:
+    /// One decoded record
+    typedef std::variant<FfMacCschedSapProvider::CschedCellConfigReqParameters,
+                         FfMacCschedSapProvider::CschedUeConfigReqParameters,
+                         FfMacCschedSapProvider::CschedLcConfigReqParameters,
+                         FfMacCschedSapProvider::CschedLcReleaseReqParameters,
+                         FfMacCschedSapProvider::CschedUeReleaseReqParameters,
+                         FfMacSchedSapProvider::SchedDlRlcBufferReqParameters,
+                         FfMacSchedSapProvider::SchedDlTriggerReqParameters,
+                         FfMacSchedSapProvider::SchedDlRachInfoReqParameters,
+                         FfMacSchedSapProvider::SchedDlCqiInfoReqParameters,
+                         FfMacSchedSapProvider::SchedUlTriggerReqParameters,
+                         FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters,
+                         FfMacSchedSapProvider::SchedUlCqiInfoReqParameters>
+        Record;
+
+    /**
+     * Read and decode a log file.
+     *
+     * \param fileName The log written by RecordingFfMacScheduler.
+     * \param cellId Set to the cell of the log.
+     * \return The records, in their original order.
+     */
+    static std::vector<Record> Load(const std::string& fileName, uint16_t& cellId)
+    {
+        std::ifstream in(fileName, std::ios::binary);
+        NS_ABORT_MSG_IF(!in.good(), "Scheduler log " << fileName << " not found");
+        FfMacLogHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        NS_ABORT_MSG_IF(!in.good() || std::memcmp(header.magic, "LTEFFMR1", 8) != 0 ||
+                            header.version != 1,
+                        fileName << " is not a scheduler log");
+        cellId = header.cellId;
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        FfMacLogReader reader(data, fileName);
+        std::vector<Record> records;
+        while (reader.m_pos < data.size())
+        {
+            auto type = static_cast<uint8_t>(data[reader.m_pos++]);
+            NS_ABORT_MSG_IF(type < CSCHED_CELL_CONFIG || type > SCHED_UL_CQI_INFO,
+                            fileName << ": bad record type " << +type);
+            records.push_back(reader.Decode(type - CSCHED_CELL_CONFIG));
+        }
+        return records;
+    }
+
+    /**
+     * Decode a field.
+     * \param value An integer, an enum or a parameter structure.
+     */
+    template <class T>
+    void operator()(T& value)
+    {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            value = static_cast<T>(GetVarint());
+        }
+        else
+        {
+            Serialize(*this, value);
+        }
+    }
+
+    /**
+     * Decode a vector field.
+     * \param values Set to the elements.
+     */
+    template <class T>
+    void operator()(std::vector<T>& values)
+    {
+        uint64_t n = GetVarint();
+        NS_ABORT_MSG_IF(n > m_data.size() - m_pos, m_fileName << " is truncated");
+        values.resize(n);
+        for (auto& value : values)
+        {
+            (*this)(value);
+        }
+    }
+
+  private:
+    /**
+     * \param data The encoded records.
+     * \param fileName The log, for the error messages.
+     */
+    FfMacLogReader(const std::string& data, const std::string& fileName)
+        : m_data(data),
+          m_fileName(fileName),
+          m_pos(0)
+    {
+    }
+
+    /**
+     * Decode the record of the given variant index.
+     *
+     * \param index The record type minus CSCHED_CELL_CONFIG.
+     * \return The record.
+     */
+    template <size_t I = 0>
+    Record Decode(size_t index)
+    {
+        if constexpr (I < std::variant_size_v<Record>)
+        {
+            if (index == I)
+            {
+                std::variant_alternative_t<I, Record> params{};
+                (*this)(params);
+                return params;
+            }
+            return Decode<I + 1>(index);
+        }
+        else
+        {
+            NS_FATAL_ERROR("Unreachable record type " << index);
+        }
+    }
+
+    /// \return The next LEB128 varint.
+    uint64_t GetVarint()
+    {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            NS_ABORT_MSG_IF(m_pos == m_data.size(), m_fileName << " is truncated");
+            auto byte = static_cast<uint8_t>(m_data[m_pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80)
+            {
+                break;
+            }
+        }
+        return value;
+    }
+
+    const std::string& m_data;     //!< Encoded records
+    const std::string& m_fileName; //!< Log file name
+    size_t m_pos;                  //!< Read offset in m_data
+};
+
+/**
+ * FF MAC scheduler recording its inputs for an offline replay.
+ *
+ * It creates the scheduler named by its Scheduler attribute and stands
+ * between it and the eNB MAC: every CSCHED and SCHED request is appended to
+ * a binary log (see FfMacLogHeader) before being passed on, the indications
+ * of the scheduler go straight to the MAC. The simulation is thus the same
+ * as with the wrapped scheduler, and scheduler-replay feeds the log of a
+ * cell to any FfMacScheduler without PHY, channel or EPC.
+ *
+ * The attributes of the wrapped scheduler are set through its defaults, e.g.
+ *
+ *   Config::SetDefault("ns3::RecordingFfMacScheduler::Scheduler",
+ *                      StringValue("ns3::PfFfMacScheduler"));
+ *   Config::SetDefault("ns3::PfFfMacScheduler::HarqEnabled", BooleanValue(true));
+ *   lteHelper->SetSchedulerType("ns3::RecordingFfMacScheduler");
+ *
+ * The cell configuration is requested while the eNB device is installed,
+ * so the records are kept in memory until Open() names the log file of the
+ * cell. The paging, MAC buffer, noise and SR requests, which the ns-3 MAC
+ * never sends, are passed on but not recorded.
+ */
+class RecordingFfMacScheduler : public FfMacScheduler
+{
+  public:
+    RecordingFfMacScheduler()
+        : m_writer(m_buffer),
+          m_schedProvider(this),
+          m_cschedProvider(this),
+          m_wrappedSched(nullptr),
+          m_wrappedCsched(nullptr),
+          m_records(0)
+    {
+    }
+
+    ~RecordingFfMacScheduler() override
+    {
+    }
+
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::RecordingFfMacScheduler")
+                .SetParent<FfMacScheduler>()
+                .AddConstructor<RecordingFfMacScheduler>()
+                .AddAttribute("Scheduler",
+                              "TypeId of the FF MAC scheduler whose inputs are recorded",
+                              StringValue("ns3::RrFfMacScheduler"),
+                              MakeStringAccessor(&RecordingFfMacScheduler::m_schedulerType),
+                              MakeStringChecker());
+        return tid;
+    }
+
+    /**
+     * Start writing the log, with the records received so far.
+     *
+     * \param fileName The log file.
+     * \param cellId The cell of the scheduler, stored in the header.
+     */
+    void Open(const std::string& fileName, uint16_t cellId)
+    {
+        m_file.open(fileName, std::ios::binary | std::ios::trunc);
+        NS_ABORT_MSG_IF(!m_file.good(), "Cannot write " << fileName);
+        FfMacLogHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "LTEFFMR1", sizeof(header.magic));
+        header.version = 1;
+        header.cellId = cellId;
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        Flush();
+    }
+
+    /// Write the remaining records and close the log.
+    void Close()
+    {
+        if (m_file.is_open())
+        {
+            Flush();
+            m_file.close();
+        }
+    }
+
+    /// \return The number of records so far.
+    uint64_t GetRecords() const
+    {
+        return m_records;
+    }
+
+    /// \return The wrapped scheduler.
+    Ptr<FfMacScheduler> GetScheduler() const
+    {
+        return m_scheduler;
+    }
+
+    void SetFfMacCschedSapUser(FfMacCschedSapUser* s) override
+    {
+        m_scheduler->SetFfMacCschedSapUser(s);
+    }
+
+    void SetFfMacSchedSapUser(FfMacSchedSapUser* s) override
+    {
+        m_scheduler->SetFfMacSchedSapUser(s);
+    }
+
+    FfMacCschedSapProvider* GetFfMacCschedSapProvider() override
+    {
+        return &m_cschedProvider;
+    }
+
+    FfMacSchedSapProvider* GetFfMacSchedSapProvider() override
+    {
+        return &m_schedProvider;
+    }
+
+    void SetLteFfrSapProvider(LteFfrSapProvider* s) override
+    {
+        m_scheduler->SetLteFfrSapProvider(s);
+    }
+
+    LteFfrSapUser* GetLteFfrSapUser() override
+    {
+        return m_scheduler->GetLteFfrSapUser();
+    }
+
+  protected:
+    void NotifyConstructionCompleted() override
+    {
+        FfMacScheduler::NotifyConstructionCompleted();
+        ObjectFactory factory(m_schedulerType);
+        m_scheduler = factory.Create<FfMacScheduler>();
+        NS_ABORT_MSG_IF(!m_scheduler, m_schedulerType << " is not an FF MAC scheduler");
+        m_wrappedSched = m_scheduler->GetFfMacSchedSapProvider();
+        m_wrappedCsched = m_scheduler->GetFfMacCschedSapProvider();
+    }
+
+    void DoInitialize() override
+    {
+        m_scheduler->Initialize();
+        FfMacScheduler::DoInitialize();
+    }
+
+    void DoDispose() override
+    {
+        Close();
+        m_buffer.clear();
+        m_scheduler->Dispose();
+        m_scheduler = nullptr;
+        FfMacScheduler::DoDispose();
+    }
+
+  private:
+    /// SCHED SAP provider recording the requests
+    class SchedProvider : public FfMacSchedSapProvider
+    {
+      public:
+        /// \param recorder The recording scheduler.
+        SchedProvider(RecordingFfMacScheduler* recorder)
+            : m_recorder(recorder)
+        {
+        }
+
+        void SchedDlRlcBufferReq(const SchedDlRlcBufferReqParameters& params) override
+        {
+            m_recorder->Record(SCHED_DL_RLC_BUFFER, params);
+            m_recorder->m_wrappedSched->SchedDlRlcBufferReq(params);
+        }
+
+        void SchedDlPagingBufferReq(const SchedDlPagingBufferReqParameters& params) override
+        {
+            m_recorder->m_wrappedSched->SchedDlPagingBufferReq(params);
+        }
+
+        void SchedDlMacBufferReq(const SchedDlMacBufferReqParameters& params) override
+        {
+            m_recorder->m_wrappedSched->SchedDlMacBufferReq(params);
+        }
+
+        void SchedDlTriggerReq(const SchedDlTriggerReqParameters& params) override
+        {
+            m_recorder->Record(SCHED_DL_TRIGGER, params);
+            m_recorder->m_wrappedSched->SchedDlTriggerReq(params);
+        }
+
+        void SchedDlRachInfoReq(const SchedDlRachInfoReqParameters& params) override
+        {
+            m_recorder->Record(SCHED_DL_RACH_INFO, params);
+            m_recorder->m_wrappedSched->SchedDlRachInfoReq(params);
+        }
+
+        void SchedDlCqiInfoReq(const SchedDlCqiInfoReqParameters& params) override
+        {
+            m_recorder->Record(SCHED_DL_CQI_INFO, params);
+            m_recorder->m_wrappedSched->SchedDlCqiInfoReq(params);
+        }
+
+        void SchedUlTriggerReq(const SchedUlTriggerReqParameters& params) override
+        {
+            m_recorder->Record(SCHED_UL_TRIGGER, params);
+            m_recorder->m_wrappedSched->SchedUlTriggerReq(params);
+        }
+
+        void SchedUlNoiseInterferenceReq(
+            const SchedUlNoiseInterferenceReqParameters& params) override
+        {
+            m_recorder->m_wrappedSched->SchedUlNoiseInterferenceReq(params);
+        }
+
+        void SchedUlSrInfoReq(const SchedUlSrInfoReqParameters& params) override
+        {
+            m_recorder->m_wrappedSched->SchedUlSrInfoReq(params);
+        }
+
+        void SchedUlMacCtrlInfoReq(const SchedUlMacCtrlInfoReqParameters& params) override
+        {
+            m_recorder->Record(SCHED_UL_MAC_CTRL_INFO, params);
+            m_recorder->m_wrappedSched->SchedUlMacCtrlInfoReq(params);
+        }
+
+        void SchedUlCqiInfoReq(const SchedUlCqiInfoReqParameters& params) override
+        {
+            m_recorder->Record(SCHED_UL_CQI_INFO, params);
+            m_recorder->m_wrappedSched->SchedUlCqiInfoReq(params);
+        }
+
+      private:
+        RecordingFfMacScheduler* m_recorder; //!< Recording scheduler
+    };
+
+    /// CSCHED SAP provider recording the requests
+    class CschedProvider : public FfMacCschedSapProvider
+    {
+      public:
+        /// \param recorder The recording scheduler.
+        CschedProvider(RecordingFfMacScheduler* recorder)
+            : m_recorder(recorder)
+        {
+        }
+
+        void CschedCellConfigReq(const CschedCellConfigReqParameters& params) override
+        {
+            m_recorder->Record(CSCHED_CELL_CONFIG, params);
+            m_recorder->m_wrappedCsched->CschedCellConfigReq(params);
+        }
+
+        void CschedUeConfigReq(const CschedUeConfigReqParameters& params) override
+        {
+            m_recorder->Record(CSCHED_UE_CONFIG, params);
+            m_recorder->m_wrappedCsched->CschedUeConfigReq(params);
+        }
+
+        void CschedLcConfigReq(const CschedLcConfigReqParameters& params) override
+        {
+            m_recorder->Record(CSCHED_LC_CONFIG, params);
+            m_recorder->m_wrappedCsched->CschedLcConfigReq(params);
+        }
+
+        void CschedLcReleaseReq(const CschedLcReleaseReqParameters& params) override
+        {
+            m_recorder->Record(CSCHED_LC_RELEASE, params);
+            m_recorder->m_wrappedCsched->CschedLcReleaseReq(params);
+        }
+
+        void CschedUeReleaseReq(const CschedUeReleaseReqParameters& params) override
+        {
+            m_recorder->Record(CSCHED_UE_RELEASE, params);
+            m_recorder->m_wrappedCsched->CschedUeReleaseReq(params);
+        }
+
+      private:
+        RecordingFfMacScheduler* m_recorder; //!< Recording scheduler
+    };
+
+    /**
+     * Append a record, and write the buffer out once it is large enough.
+     *
+     * \param type The record type.
+     * \param params The SAP parameters.
+     */
+    template <class T>
+    void Record(FfMacLogRecord type, const T& params)
+    {
+        m_writer.Record(type, params);
+        m_records++;
+        if (m_file.is_open() && m_buffer.size() >= 64 * 1024)
+        {
+            Flush();
+        }
+    }
+
+    /// Write the buffered records to the log file.
+    void Flush()
+    {
+        m_file.write(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+
+    std::string m_schedulerType;             //!< TypeId of the wrapped scheduler
+    Ptr<FfMacScheduler> m_scheduler;         //!< Wrapped scheduler
+    std::string m_buffer;                    //!< Records not written yet
+    FfMacLogWriter m_writer;                 //!< Encoder into m_buffer
+    std::ofstream m_file;                    //!< Log file
+    SchedProvider m_schedProvider;           //!< SCHED SAP given to the MAC
+    CschedProvider m_cschedProvider;         //!< CSCHED SAP given to the MAC
+    FfMacSchedSapProvider* m_wrappedSched;   //!< SCHED SAP of the wrapped scheduler
+    FfMacCschedSapProvider* m_wrappedCsched; //!< CSCHED SAP of the wrapped scheduler
+    uint64_t m_records;                      //!< Records so far
+};
+
+NS_OBJECT_ENSURE_REGISTERED(RecordingFfMacScheduler);
+
+} // namespace ns3
+
+#endif // RECORDING_FF_MAC_SCHEDULER_H
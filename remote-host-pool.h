@@ -0,0 +1,114 @@
+#ifndef REMOTE_HOST_POOL_H
+#define REMOTE_HOST_POOL_H
+
+#include <ns3/core-module.h>
+#include <ns3/internet-module.h>
+#include <ns3/point-to-point-module.h>
+
+namespace ns3
+{
+
+/**
+ * A set of remote hosts behind the PGW, each on its own SGi point-to-point
+ * link and subnet, sharing the UE flows between them.
+ *
+ * With a single remote host every client application, socket and the one SGi
+ * queue sit on one node, whose event load grows with the number of UEs. The
+ * pool gives host k the subnet 1.k.0.0/16 on its own link to the PGW and a
+ * route to the UE network through it; UE u is served by host u % N, so the
+ * load per host and per link stays bounded when N grows with the UE count.
+ */
+class RemoteHostPool
+{
+  public:
+    /**
+     * \param pgw The PGW node.
+     * \param numHosts Number of remote hosts, at most 256.
+     */
+    RemoteHostPool(Ptr<Node> pgw, uint32_t numHosts)
+        : m_pgw(pgw)
+    {
+        NS_ABORT_MSG_IF(numHosts == 0 || numHosts > 256, "Between 1 and 256 remote hosts");
+        m_hosts.Create(numHosts);
+    }
+
+    /**
+     * Install the internet stack on the hosts, link each one to the PGW and
+     * route the UE network through that link.
+     *
+     * \param p2p Helper for the SGi links.
+     * \param ueNetwork The UE network.
+     * \param ueMask The UE network mask.
+     */
+    void Install(PointToPointHelper& p2p, Ipv4Address ueNetwork, Ipv4Mask ueMask)
+    {
+        InternetStackHelper internet;
+        internet.Install(m_hosts);
+
+        Ipv4AddressHelper ipv4h;
+        Ipv4StaticRoutingHelper ipv4RoutingHelper;
+        for (uint32_t k = 0; k < m_hosts.GetN(); k++)
+        {
+            Ptr<Node> host = m_hosts.Get(k);
+            NetDeviceContainer devices = p2p.Install(m_pgw, host);
+            std::ostringstream base;
+            base << "1." << k << ".0.0";
+            ipv4h.SetBase(base.str().c_str(), "255.255.0.0");
+            Ipv4InterfaceContainer ifaces = ipv4h.Assign(devices);
+            m_addresses.push_back(ifaces.GetAddress(1));
+
+            // interface 0 is localhost, 1 is the p2p device
+            Ptr<Ipv4StaticRouting> hostStaticRouting =
+                ipv4RoutingHelper.GetStaticRouting(host->GetObject<Ipv4>());
+            hostStaticRouting->AddNetworkRouteTo(ueNetwork, ueMask, 1);
+        }
+    }
+
+    /// \return The number of remote hosts.
+    uint32_t GetN() const
+    {
+        return m_hosts.GetN();
+    }
+
+    /// \return The remote host nodes.
+    NodeContainer GetNodes() const
+    {
+        return m_hosts;
+    }
+
+    /**
+     * \param k Index of a remote host.
+     * \return Its address on its SGi link.
+     */
+    Ipv4Address GetAddress(uint32_t k) const
+    {
+        return m_addresses.at(k);
+    }
+
+    /**
+     * \param ueIndex Index of a UE.
+     * \return The remote host serving it.
+     */
+    Ptr<Node> GetHostForUe(uint32_t ueIndex) const
+    {
+        return m_hosts.Get(ueIndex % m_hosts.GetN());
+    }
+
+    /**
+     * \param ueIndex Index of a UE.
+     * \return The address of the remote host serving it.
+     */
+    Ipv4Address GetAddressForUe(uint32_t ueIndex) const
+    {
+        return m_addresses.at(ueIndex % m_hosts.GetN());
+    }
+
+  private:
+    Ptr<Node> m_pgw;                      //!< PGW node
+    NodeContainer m_hosts;                //!< Remote hosts
+    std::vector<Ipv4Address> m_addresses; //!< SGi address of each host
+};
+
+} // namespace ns3
+
+#endif // REMOTE_HOST_POOL_H
@@ -0,0 +1,225 @@
+#ifndef RLC_BUFFER_MONITOR_H
+#define RLC_BUFFER_MONITOR_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Occupancy and drops of the downlink RLC transmit buffers of every cell.
+ *
+ * The UM and AM entities queue the PDCP PDUs up to their MaxTxBufferSize
+ * attribute per bearer and drop the SDUs beyond it (their TxDrop trace), so
+ * the memory an overloaded cell holds is bounded by its bearers times that
+ * size. To observe the buffers without changing the RLC, each bearer set up
+ * at an eNB gets a shim between its RLC and the MAC SAP of the eNB: it
+ * forwards everything, and keeps the last buffer status (transmission,
+ * retransmission and status PDU bytes) the RLC reported. The RLC owns its
+ * shim, through the callback of its TxDrop trace, so the shim goes with the
+ * RLC when the bearer is released or handed over, and takes its bytes out of
+ * the cell then. The monitor reports, per cell:
+ *
+ *  - the time-weighted mean and the peak of the bytes queued in the cell
+ *  - the peak of the bytes queued by one bearer, against MaxTxBufferSize
+ *  - the SDUs and bytes dropped on a full buffer
+ *
+ * With fullBufferDl the buffers stay close to MaxTxBufferSize by design, see
+ * FullBufferSource.
+ */
+class RlcBufferMonitor
+{
+  public:
+    ~RlcBufferMonitor()
+    {
+        for (const auto& cell : m_cells)
+        {
+            cell->stopped = true;
+        }
+    }
+
+    /**
+     * Follow the data radio bearers set up from now on at the eNBs. To be
+     * called before the UEs attach.
+     *
+     * \param enbDevs The eNB devices.
+     */
+    void Install(const NetDeviceContainer& enbDevs)
+    {
+        for (uint32_t i = 0; i < enbDevs.GetN(); i++)
+        {
+            Ptr<LteEnbNetDevice> enbDev = enbDevs.Get(i)->GetObject<LteEnbNetDevice>();
+            NS_ABORT_MSG_IF(!enbDev, "Device " << i << " is not an eNB");
+            Ptr<Cell> cell = Create<Cell>();
+            cell->cellId = enbDev->GetCellId();
+            // The RRC hands this SAP to the RLC of every bearer
+            cell->macSapProvider = enbDev->GetComponentCarrierManager()->GetLteMacSapProvider();
+            Ptr<LteEnbRrc> rrc = enbDev->GetRrc();
+            rrc->TraceConnectWithoutContext(
+                "DrbCreated",
+                MakeBoundCallback(&RlcBufferMonitor::DrbCreated, cell, PeekPointer(rrc)));
+            m_cells.push_back(cell);
+        }
+    }
+
+    /**
+     * Print the occupancy and drops of each cell, and stop monitoring.
+     * \param os The output stream.
+     */
+    void Print(std::ostream& os)
+    {
+        os << "Downlink RLC transmit buffers, MaxTxBufferSize = "
+           << GetMaxTxBufferSize(LteRlcUm::GetTypeId()) << " B (UM), "
+           << GetMaxTxBufferSize(LteRlcAm::GetTypeId()) << " B (AM)" << std::endl;
+        os << std::setw(6) << "cell" << std::setw(9) << "bearers" << std::setw(12) << "mean KiB"
+           << std::setw(12) << "peak KiB" << std::setw(14) << "bearer peak B" << std::setw(12)
+           << "drops" << std::setw(14) << "dropped KiB" << std::endl;
+        double seconds = Simulator::Now().GetSeconds();
+        for (const auto& cell : m_cells)
+        {
+            double byteSeconds =
+                cell->byteSeconds + cell->bytes * (Simulator::Now() - cell->since).GetSeconds();
+            os << std::setw(6) << cell->cellId << std::setw(9) << cell->bearers
+               << std::setw(12) << std::setprecision(4)
+               << (seconds > 0 ? byteSeconds / seconds / 1024 : 0) << std::setw(12)
+               << cell->peakBytes / 1024.0 << std::setw(14) << cell->peakBearerBytes
+               << std::setw(12) << cell->drops << std::setw(14) << cell->droppedBytes / 1024.0
+               << std::endl;
+            cell->stopped = true;
+        }
+    }
+
+  private:
+    /// Bearers and counters of one cell
+    struct Cell : public SimpleRefCount<Cell>
+    {
+        uint16_t cellId = 0;                         //!< Cell id
+        LteMacSapProvider* macSapProvider = nullptr; //!< MAC SAP the bearers forward to
+        uint32_t bearers = 0;                        //!< Bearers whose RLC is alive
+        uint64_t bytes = 0;                          //!< Bytes queued now
+        Time since;                                  //!< Time of the last change of bytes
+        double byteSeconds = 0;                      //!< Integral of bytes until since
+        uint64_t peakBytes = 0;                      //!< Peak of bytes
+        uint64_t peakBearerBytes = 0;                //!< Peak of the bytes of one bearer
+        uint64_t drops = 0;                          //!< SDUs dropped
+        uint64_t droppedBytes = 0;                   //!< Bytes of the SDUs dropped
+        bool stopped = false;                        //!< Set once printed
+    };
+
+    /// Shim between the RLC of one bearer and the MAC SAP of its eNB
+    class Bearer : public LteMacSapProvider, public SimpleRefCount<Bearer>
+    {
+      public:
+        /**
+         * \param bearerCell The cell of the bearer.
+         */
+        Bearer(Ptr<Cell> bearerCell)
+            : cell(bearerCell)
+        {
+            cell->bearers++;
+        }
+
+        /// The RLC is gone: its buffer is empty.
+        ~Bearer() override
+        {
+            SetBytes(0);
+            cell->bearers--;
+        }
+
+        void TransmitPdu(TransmitPduParameters params) override
+        {
+            cell->macSapProvider->TransmitPdu(params);
+        }
+
+        void ReportBufferStatus(ReportBufferStatusParameters params) override
+        {
+            SetBytes(params.txQueueSize + params.retxQueueSize + params.statusPduSize);
+            cell->macSapProvider->ReportBufferStatus(params);
+        }
+
+        /**
+         * Update the bytes queued by the bearer, and those of its cell.
+         * \param newBytes The bytes queued.
+         */
+        void SetBytes(uint64_t newBytes)
+        {
+            if (cell->stopped)
+            {
+                return; // possibly after Simulator::Destroy()
+            }
+            Time now = Simulator::Now();
+            cell->byteSeconds += cell->bytes * (now - cell->since).GetSeconds();
+            cell->since = now;
+            cell->bytes = cell->bytes - bytes + newBytes;
+            cell->peakBytes = std::max(cell->peakBytes, cell->bytes);
+            cell->peakBearerBytes = std::max(cell->peakBearerBytes, newBytes);
+            bytes = newBytes;
+        }
+
+        /**
+         * An SDU was dropped on a full buffer.
+         * \param bearer The bearer.
+         * \param packet The SDU.
+         */
+        static void TxDrop(Ptr<Bearer> bearer, Ptr<const Packet> packet)
+        {
+            bearer->cell->drops++;
+            bearer->cell->droppedBytes += packet->GetSize();
+        }
+
+        Ptr<Cell> cell;     //!< Cell of the bearer
+        uint64_t bytes = 0; //!< Bytes last reported
+    };
+
+    /**
+     * \param tid The TypeId of an RLC.
+     * \return The default of its MaxTxBufferSize attribute, as set in [ns3].
+     */
+    static uint64_t GetMaxTxBufferSize(TypeId tid)
+    {
+        TypeId::AttributeInformation info;
+        if (!tid.LookupAttributeByName("MaxTxBufferSize", &info))
+        {
+            return 0;
+        }
+        return DynamicCast<const UintegerValue>(info.initialValue)->Get();
+    }
+
+    /**
+     * A DRB was set up: put the shim between its RLC and the MAC.
+     *
+     * \param cell The cell.
+     * \param rrc The RRC of the eNB, not held: it would hold itself.
+     * \param rnti The RNTI.
+     * \param lcid The logical channel.
+     */
+    static void DrbCreated(Ptr<Cell> cell,
+                           LteEnbRrc* rrc,
+                           uint64_t /* imsi */,
+                           uint16_t /* cellId */,
+                           uint16_t rnti,
+                           uint8_t lcid)
+    {
+        // DRB ids are the LCIDs minus the two SRBs
+        ObjectMapValue drbs;
+        rrc->GetUeManager(rnti)->GetAttribute("DataRadioBearerMap", drbs);
+        Ptr<LteDataRadioBearerInfo> drb = DynamicCast<LteDataRadioBearerInfo>(drbs.Get(lcid - 2));
+        NS_ABORT_MSG_IF(!drb, "No DRB for LCID " << +lcid << " of RNTI " << rnti);
+        Ptr<Bearer> bearer = Create<Bearer>(cell);
+        drb->m_rlc->SetLteMacSapProvider(PeekPointer(bearer));
+        // The callback holds the bearer: it goes with the RLC
+        drb->m_rlc->TraceConnectWithoutContext("TxDrop",
+                                               MakeBoundCallback(&Bearer::TxDrop, bearer));
+    }
+
+    std::vector<Ptr<Cell>> m_cells; //!< Cells, in the order of the eNB devices
+};
+
+} // namespace ns3
+
+#endif // RLC_BUFFER_MONITOR_H
@@ -0,0 +1,328 @@
+#ifndef RLF_MONITOR_H
+#define RLF_MONITOR_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+
+#include <array>
+#include <iomanip>
+
+namespace ns3
+{
+
+/**
+ * Counts radio link failures and measures outages from the UE RRC
+ * indications.
+ *
+ * Each UE has a fixed-size state machine in a flat array indexed by IMSI:
+ *
+ *   CONNECTED --N310 out-of-sync--> OUT_OF_SYNC --T310 expiry--> RLF
+ *       ^                          |                         |
+ *       +------ N311 in-sync ------+                         |
+ *       +-------- handover --------+                         |
+ *       +-------------- connection established --------------+
+ *
+ * ns-3 has no RRC re-establishment: after an RLF the UE goes back to cell
+ * selection and a new connection establishment, which ends the outage. The
+ * monitor reports, per cell (the serving cell when T310 started):
+ *
+ *  - RLFs, and RLFs per connected UE-hour
+ *  - out-of-sync episodes (N310 consecutive out-of-sync indications, which
+ *    start T310), and those recovered before T310 expired
+ *  - histograms of the outage (T310 start to N311, handover or connection)
+ *    and recovery (RLF to connection) durations, in power of two ms bins
+ *
+ * Every indication costs an array lookup and a few stores, and the memory
+ * does not grow with the run length, so it can stay on in every run.
+ */
+class RlfMonitor
+{
+  public:
+    /// Number of histogram bins: [0, 1) ms, [1, 2) ms, ... [2^(n-2), inf) ms
+    static constexpr uint32_t NUM_BINS = 18;
+
+    /**
+     * \param numUes Number of UEs, whose IMSIs are 1 to numUes.
+     * \param numCells Number of cells, whose ids are 1 to numCells.
+     */
+    RlfMonitor(uint32_t numUes, uint32_t numCells)
+        : m_ues(numUes),
+          m_cells(numCells),
+          m_n310(1),
+          m_n311(1)
+    {
+    }
+
+    /**
+     * Connect to the RRC of every UE. To be called after the UE devices are
+     * installed.
+     */
+    void Install()
+    {
+        // Out-of-sync indications starting T310, and in-sync indications
+        // stopping it, as set for the UE RRCs
+        TypeId::AttributeInformation info;
+        if (LteUeRrc::GetTypeId().LookupAttributeByName("N310", &info))
+        {
+            m_n310 = DynamicCast<const UintegerValue>(info.initialValue)->Get();
+        }
+        if (LteUeRrc::GetTypeId().LookupAttributeByName("N311", &info))
+        {
+            m_n311 = DynamicCast<const UintegerValue>(info.initialValue)->Get();
+        }
+        Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/LteUeRrc/PhySyncDetection",
+                                      MakeCallback(&RlfMonitor::PhySyncDetection, this));
+        Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/LteUeRrc/RadioLinkFailure",
+                                      MakeCallback(&RlfMonitor::RadioLinkFailure, this));
+        Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/LteUeRrc/ConnectionEstablished",
+                                      MakeCallback(&RlfMonitor::Connected, this));
+        Config::ConnectWithoutContext("/NodeList/*/DeviceList/*/LteUeRrc/HandoverEndOk",
+                                      MakeCallback(&RlfMonitor::Connected, this));
+    }
+
+    /**
+     * Print the counters and histograms of each cell.
+     * \param os The output stream.
+     */
+    void Print(std::ostream& os)
+    {
+        // Close the connected time of the UEs still connected
+        int64_t now = Simulator::Now().GetNanoSeconds();
+        for (UeState& ue : m_ues)
+        {
+            if (ue.state == CONNECTED || ue.state == OUT_OF_SYNC)
+            {
+                AddConnectedTime(ue, now);
+            }
+        }
+
+        os << "Radio link failures (T310 expiry), N310 = " << m_n310 << ", N311 = " << m_n311
+           << std::endl;
+        os << std::setw(6) << "cell" << std::setw(10) << "UE-hours" << std::setw(8) << "RLFs"
+           << std::setw(12) << "RLF/UE-h" << std::setw(12) << "outOfSync" << std::setw(12)
+           << "recovered" << std::setw(16) << "mean outage ms" << std::endl;
+        for (uint32_t c = 0; c < m_cells.size(); c++)
+        {
+            const CellStats& cell = m_cells[c];
+            double ueHours = cell.connectedTime / 3600e9;
+            os << std::setw(6) << c + 1 << std::setw(10) << std::setprecision(4) << ueHours
+               << std::setw(8) << cell.rlfs << std::setw(12)
+               << (ueHours > 0 ? cell.rlfs / ueHours : 0) << std::setw(12) << cell.outOfSync
+               << std::setw(12) << cell.syncRecovered << std::setw(16)
+               << (cell.outages > 0 ? cell.outageSum / cell.outages / 1e6 : 0) << std::endl;
+        }
+        PrintHistograms(os, "Outage", &CellStats::outageHistogram);
+        PrintHistograms(os, "Recovery after RLF", &CellStats::recoveryHistogram);
+    }
+
+  private:
+    /// State of a UE
+    enum State : uint8_t
+    {
+        IDLE = 0,        //!< Not connected yet, or back to cell selection
+        CONNECTED = 1,   //!< Connected and in sync
+        OUT_OF_SYNC = 2, //!< Out-of-sync indicated, T310 running
+        RLF = 3,         //!< T310 expired, until the next connection
+    };
+
+    /// Fixed-size state of one UE
+    struct UeState
+    {
+        State state = IDLE;      //!< State
+        uint16_t cellId = 0;     //!< Serving cell, or cell of the outage
+        int64_t since = 0;       //!< Start of the connected time in cellId, in ns
+        int64_t outageStart = 0; //!< T310 start, in ns
+        int64_t rlfTime = 0;     //!< T310 expiry, in ns
+    };
+
+    /// Counters of one cell
+    struct CellStats
+    {
+        double connectedTime = 0;                          //!< Connected UE time, in ns
+        uint64_t rlfs = 0;                                 //!< Radio link failures
+        uint64_t outOfSync = 0;                            //!< Out-of-sync episodes
+        uint64_t syncRecovered = 0;                        //!< Episodes ended by N311
+        uint64_t outages = 0;                              //!< Ended outages
+        double outageSum = 0;                              //!< Sum of the outages, in ns
+        std::array<uint64_t, NUM_BINS> outageHistogram{};   //!< Outage durations
+        std::array<uint64_t, NUM_BINS> recoveryHistogram{}; //!< RLF recovery durations
+    };
+
+    /**
+     * \param imsi An IMSI.
+     * \return The state of the UE.
+     */
+    UeState& GetUe(uint64_t imsi)
+    {
+        NS_ABORT_MSG_IF(imsi < 1 || imsi > m_ues.size(), "IMSI " << imsi << " out of range");
+        return m_ues[imsi - 1];
+    }
+
+    /**
+     * \param cellId A cell id.
+     * \return The counters of the cell.
+     */
+    CellStats& GetCell(uint16_t cellId)
+    {
+        NS_ABORT_MSG_IF(cellId < 1 || cellId > m_cells.size(),
+                        "Cell " << cellId << " out of range");
+        return m_cells[cellId - 1];
+    }
+
+    /**
+     * Add the time a UE spent connected in its cell.
+     * \param ue The UE.
+     * \param now The end of the connected time, in ns.
+     */
+    void AddConnectedTime(UeState& ue, int64_t now)
+    {
+        GetCell(ue.cellId).connectedTime += now - ue.since;
+        ue.since = now;
+    }
+
+    /**
+     * \param duration A duration, in ns.
+     * \return Its histogram bin.
+     */
+    static uint32_t Bin(int64_t duration)
+    {
+        uint64_t ms = static_cast<uint64_t>(duration / 1000000);
+        uint32_t bin = 0;
+        while (ms > 0 && bin < NUM_BINS - 1)
+        {
+            ms >>= 1;
+            bin++;
+        }
+        return bin;
+    }
+
+    /**
+     * \param imsi The IMSI.
+     * \param rnti The RNTI.
+     * \param cellId The serving cell.
+     * \param type "Notify out of sync" or "Notify in sync".
+     * \param count Consecutive indications of that type.
+     */
+    void PhySyncDetection(uint64_t imsi,
+                          uint16_t rnti,
+                          uint16_t cellId,
+                          std::string type,
+                          uint8_t count)
+    {
+        UeState& ue = GetUe(imsi);
+        int64_t now = Simulator::Now().GetNanoSeconds();
+        if (type == "Notify out of sync" && ue.state == CONNECTED && count >= m_n310)
+        {
+            ue.state = OUT_OF_SYNC;
+            ue.outageStart = now;
+            GetCell(ue.cellId).outOfSync++;
+        }
+        else if (type == "Notify in sync" && ue.state == OUT_OF_SYNC && count >= m_n311)
+        {
+            ue.state = CONNECTED;
+            CellStats& cell = GetCell(ue.cellId);
+            cell.syncRecovered++;
+            cell.outages++;
+            cell.outageSum += now - ue.outageStart;
+            cell.outageHistogram[Bin(now - ue.outageStart)]++;
+        }
+    }
+
+    /**
+     * \param imsi The IMSI.
+     * \param cellId The serving cell.
+     * \param rnti The RNTI.
+     */
+    void RadioLinkFailure(uint64_t imsi, uint16_t cellId, uint16_t rnti)
+    {
+        UeState& ue = GetUe(imsi);
+        if (ue.state == IDLE || ue.state == RLF)
+        {
+            return;
+        }
+        int64_t now = Simulator::Now().GetNanoSeconds();
+        if (ue.state == CONNECTED)
+        {
+            ue.outageStart = now; // T310 start not seen
+        }
+        AddConnectedTime(ue, now);
+        ue.state = RLF;
+        ue.rlfTime = now;
+        GetCell(ue.cellId).rlfs++;
+    }
+
+    /**
+     * Connection established, or handover completed.
+     *
+     * \param imsi The IMSI.
+     * \param cellId The new serving cell.
+     * \param rnti The RNTI.
+     */
+    void Connected(uint64_t imsi, uint16_t cellId, uint16_t rnti)
+    {
+        UeState& ue = GetUe(imsi);
+        int64_t now = Simulator::Now().GetNanoSeconds();
+        if (ue.state == RLF)
+        {
+            // The outage is counted in the cell where it started
+            CellStats& cell = GetCell(ue.cellId);
+            cell.outages++;
+            cell.outageSum += now - ue.outageStart;
+            cell.outageHistogram[Bin(now - ue.outageStart)]++;
+            cell.recoveryHistogram[Bin(now - ue.rlfTime)]++;
+        }
+        else if (ue.state == OUT_OF_SYNC)
+        {
+            // A handover ends the episode before N311 or T310 do
+            AddConnectedTime(ue, now);
+            CellStats& cell = GetCell(ue.cellId);
+            cell.outages++;
+            cell.outageSum += now - ue.outageStart;
+            cell.outageHistogram[Bin(now - ue.outageStart)]++;
+        }
+        else if (ue.state != IDLE)
+        {
+            AddConnectedTime(ue, now);
+        }
+        ue.state = CONNECTED;
+        ue.cellId = cellId;
+        ue.since = now;
+    }
+
+    /**
+     * Print one histogram per cell, one column per bin.
+     *
+     * \param os The output stream.
+     * \param name The histogram name.
+     * \param histogram The histogram member.
+     */
+    void PrintHistograms(std::ostream& os,
+                         const std::string& name,
+                         std::array<uint64_t, NUM_BINS> CellStats::*histogram) const
+    {
+        os << name << " durations, upper bin bounds in ms:" << std::endl << std::setw(6) << "cell";
+        for (uint32_t b = 0; b < NUM_BINS - 1; b++)
+        {
+            os << std::setw(7) << (1u << b);
+        }
+        os << std::setw(7) << "inf" << std::endl;
+        for (uint32_t c = 0; c < m_cells.size(); c++)
+        {
+            os << std::setw(6) << c + 1;
+            for (uint64_t count : m_cells[c].*histogram)
+            {
+                os << std::setw(7) << count;
+            }
+            os << std::endl;
+        }
+    }
+
+    std::vector<UeState> m_ues;     //!< UE states, by IMSI - 1
+    std::vector<CellStats> m_cells; //!< Cell counters, by cell id - 1
+    uint32_t m_n310;                //!< Out-of-sync indications starting T310
+    uint32_t m_n311;                //!< In-sync indications stopping T310
+};
+
+} // namespace ns3
+
+#endif // RLF_MONITOR_H
@@ -0,0 +1,93 @@
+#ifndef RNG_STREAM_ALLOCATOR_H
+#define RNG_STREAM_ALLOCATOR_H
+
+#include <ns3/core-module.h>
+
+namespace ns3
+{
+
+/**
+ * Fixed layout of random variable stream numbers, keyed by entity and
+ * component.
+ *
+ * Without AssignStreams() the streams are handed out in object creation
+ * order, so adding a UE or drawing one more value before another shifts the
+ * random sequences of everything created after it. Here the first stream of
+ * a (kind, index, component) slot is computed from the key alone:
+ *
+ *   base + ((kind * 2^32 + index) * NUM_COMPONENTS + component) * slotSize
+ *
+ * so UE 17 gets the same sequences whatever the number of UEs, the order in
+ * which they are built, or the process they are built in. Runs are still
+ * told apart with RngRun; with the same RngRun, a sweep point run in one
+ * process or split between several draws the same values for each UE, which
+ * is also what common random numbers need.
+ */
+class RngStreamAllocator
+{
+  public:
+    /// Kind of entity owning a slot
+    enum Kind : uint64_t
+    {
+        GLOBAL = 0, //!< Shared models (channel, EPC)
+        ENB = 1,    //!< eNBs, by eNB index
+        UE = 2,     //!< UEs, by UE index (IMSI - 1)
+    };
+
+    /// Component of an entity owning a slot
+    enum Component : uint64_t
+    {
+        MOBILITY = 0,    //!< Mobility model
+        POSITION = 1,    //!< Initial position draw
+        LTE_DEVICE = 2,  //!< LTE PHY and MAC
+        INTERNET = 3,    //!< Internet stack
+        APPLICATION = 4, //!< Application start times and traffic
+        CHANNEL = 5,     //!< Propagation and fading models
+        EPC = 6,         //!< EPC nodes
+        NUM_COMPONENTS = 8,
+    };
+
+    /**
+     * \param base First stream of the layout.
+     * \param slotSize Streams reserved per slot, enough for the largest
+     *        component (an LTE device with its EPC streams uses less than 16).
+     */
+    RngStreamAllocator(int64_t base = 0, uint32_t slotSize = 64)
+        : m_base(base),
+          m_slotSize(slotSize)
+    {
+    }
+
+    /**
+     * \param kind The kind of entity.
+     * \param index Index of the entity among its kind.
+     * \param component The component.
+     * \return The first stream of the slot.
+     */
+    int64_t GetStream(Kind kind, uint32_t index, Component component) const
+    {
+        NS_ASSERT(component < NUM_COMPONENTS);
+        uint64_t slot = ((kind << 32) + index) * NUM_COMPONENTS + component;
+        return m_base + static_cast<int64_t>(slot * m_slotSize);
+    }
+
+    /**
+     * Check that an AssignStreams() call stayed within its slot.
+     *
+     * \param used Number of streams the call used.
+     */
+    void CheckUsed(int64_t used) const
+    {
+        NS_ABORT_MSG_IF(used > m_slotSize,
+                        "AssignStreams used " << used << " streams, the slot holds "
+                                              << m_slotSize);
+    }
+
+  private:
+    int64_t m_base;      //!< First stream
+    uint32_t m_slotSize; //!< Streams per slot
+};
+
+} // namespace ns3
+
+#endif // RNG_STREAM_ALLOCATOR_H
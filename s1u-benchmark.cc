@@ -0,0 +1,359 @@
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <map>
+
+using namespace ns3;
+
+/*
+ * Measures the per packet cost of the downlink path of the EPC model, from
+ * the SGi link of the PGW to the radio bearer of the eNB. The PGW finds the
+ * bearer of the destination UE and GTP-U encapsulates the packet towards the
+ * SGW (S5), the SGW swaps the tunnel towards the eNB (S1-U), and the eNB
+ * decapsulates it and finds the radio bearer of the tunnel.
+ *
+ * Every hop performs the same packet operations as the ns-3 stacks and EPC
+ * applications: a copy on IPv4 receive, the removal of the PPP, IPv4, UDP and
+ * GTP-U headers, and their addition on the way out. The tunnel lookups use
+ * either a std::map, like the EPC applications, or a flat open addressing
+ * table, to size what a flat table would save on a large number of bearers.
+ */
+
+/// UDP port of GTP-U
+const uint16_t GTPU_PORT = 2152;
+
+uint64_t g_lookupSink = 0; //!< Keeps the lookup-only loop from being optimized out
+
+/**
+ * Open addressing hash table from a non-zero 32 bit key (TEID or IPv4
+ * address) to a 32 bit value, with linear probing. Entries are never removed.
+ */
+class FlatTable
+{
+  public:
+    /// Value returned for a missing key
+    static constexpr uint32_t NOT_FOUND = 0xffffffff;
+
+    /**
+     * \param capacity Number of entries the table will hold.
+     */
+    FlatTable(uint32_t capacity)
+        : m_shift(32)
+    {
+        uint32_t size = 1;
+        while (size < 2 * capacity)
+        {
+            size *= 2;
+            m_shift--;
+        }
+        m_slots.assign(size, Slot{0, 0});
+        m_mask = size - 1;
+    }
+
+    /**
+     * \param key The key, non-zero.
+     * \param value The value.
+     */
+    void Insert(uint32_t key, uint32_t value)
+    {
+        NS_ASSERT(key != 0);
+        uint32_t i = Hash(key);
+        while (m_slots[i].key != 0 && m_slots[i].key != key)
+        {
+            i = (i + 1) & m_mask;
+        }
+        m_slots[i] = Slot{key, value};
+    }
+
+    /**
+     * \param key A key, non-zero.
+     * \return Its value, NOT_FOUND if the key is not in the table.
+     */
+    uint32_t Find(uint32_t key) const
+    {
+        // The table is at most half full, so the probe ends on an empty slot
+        uint32_t i = Hash(key);
+        while (m_slots[i].key != key)
+        {
+            if (m_slots[i].key == 0)
+            {
+                return NOT_FOUND;
+            }
+            i = (i + 1) & m_mask;
+        }
+        return m_slots[i].value;
+    }
+
+  private:
+    /// A table slot, key 0 when empty
+    struct Slot
+    {
+        uint32_t key;   //!< Key
+        uint32_t value; //!< Value
+    };
+
+    /**
+     * Fibonacci hashing: TEIDs and UE addresses are allocated sequentially,
+     * the multiplication spreads them over the table.
+     *
+     * \param key The key.
+     * \return The home slot of the key.
+     */
+    uint32_t Hash(uint32_t key) const
+    {
+        return m_shift == 32 ? 0 : (key * 2654435769U) >> m_shift;
+    }
+
+    std::vector<Slot> m_slots; //!< Slots
+    uint32_t m_mask;           //!< Number of slots minus one
+    uint32_t m_shift;          //!< 32 minus log2 of the number of slots
+};
+
+/// The same interface over a std::map, as used by the EPC applications
+class MapTable
+{
+  public:
+    /**
+     * \param capacity Unused.
+     */
+    MapTable(uint32_t /* capacity */)
+    {
+    }
+
+    /**
+     * \param key The key.
+     * \param value The value.
+     */
+    void Insert(uint32_t key, uint32_t value)
+    {
+        m_map[key] = value;
+    }
+
+    /**
+     * \param key A key.
+     * \return Its value, FlatTable::NOT_FOUND if the key is not in the table.
+     */
+    uint32_t Find(uint32_t key) const
+    {
+        auto it = m_map.find(key);
+        return it == m_map.end() ? FlatTable::NOT_FOUND : it->second;
+    }
+
+  private:
+    std::map<uint32_t, uint32_t> m_map; //!< Entries
+};
+
+/**
+ * Receive a packet on a point-to-point IPv4 interface and strip the link and
+ * network headers.
+ *
+ * \param packet The packet on the wire.
+ * \param [out] ip The IPv4 header.
+ * \return The packet as seen by the transport layer.
+ */
+Ptr<Packet> ReceiveIpv4(Ptr<Packet> packet, Ipv4Header& ip)
+{
+    PppHeader ppp;
+    packet->RemoveHeader(ppp);
+    Ptr<Packet> p = packet->Copy(); // Ipv4L3Protocol::Receive
+    p->RemoveHeader(ip);
+    return p;
+}
+
+/**
+ * Send a packet over a point-to-point IPv4 interface.
+ *
+ * \param packet The transport layer packet.
+ * \param src Source address.
+ * \param dst Destination address.
+ * \param protocol IP protocol number.
+ */
+void SendIpv4(Ptr<Packet> packet, Ipv4Address src, Ipv4Address dst, uint8_t protocol)
+{
+    Ipv4Header ip;
+    ip.SetSource(src);
+    ip.SetDestination(dst);
+    ip.SetProtocol(protocol);
+    ip.SetPayloadSize(packet->GetSize());
+    ip.SetTtl(64);
+    packet->AddHeader(ip);
+    PppHeader ppp;
+    ppp.SetProtocol(0x0021);
+    packet->AddHeader(ppp);
+}
+
+/**
+ * GTP-U encapsulate a packet and send it.
+ *
+ * \param packet The user packet.
+ * \param teid The tunnel id.
+ * \param src Local tunnel endpoint.
+ * \param dst Remote tunnel endpoint.
+ */
+void SendGtpu(Ptr<Packet> packet, uint32_t teid, Ipv4Address src, Ipv4Address dst)
+{
+    GtpuHeader gtpu;
+    gtpu.SetTeid(teid);
+    gtpu.SetLength(packet->GetSize() + gtpu.GetSerializedSize() - 8);
+    packet->AddHeader(gtpu);
+    UdpHeader udp;
+    udp.SetSourcePort(GTPU_PORT);
+    udp.SetDestinationPort(GTPU_PORT);
+    packet->AddHeader(udp);
+    SendIpv4(packet, src, dst, UdpL4Protocol::PROT_NUMBER);
+}
+
+/**
+ * Receive a GTP-U packet and decapsulate it.
+ *
+ * \param packet The packet on the wire.
+ * \param [out] teid The tunnel id.
+ * \return The user packet.
+ */
+Ptr<Packet> ReceiveGtpu(Ptr<Packet> packet, uint32_t& teid)
+{
+    Ipv4Header ip;
+    Ptr<Packet> p = ReceiveIpv4(packet, ip);
+    UdpHeader udp;
+    p->RemoveHeader(udp);
+    GtpuHeader gtpu;
+    p->RemoveHeader(gtpu);
+    teid = gtpu.GetTeid();
+    return p;
+}
+
+/**
+ * Push packets through PGW, SGW and eNB with one kind of tunnel table.
+ *
+ * \param bearers Number of UEs, each with one bearer.
+ * \param packets Number of packets.
+ * \param payloadSize UDP payload size.
+ * \param [out] nsPerLookup Time per tunnel lookup alone, in ns.
+ * \param [out] checksum Sum of the radio bearers and sizes of the packets.
+ * \return Time per packet, in ns.
+ */
+template <typename Table>
+double RunPath(uint32_t bearers,
+               uint32_t packets,
+               uint32_t payloadSize,
+               double& nsPerLookup,
+               uint64_t& checksum)
+{
+    const Ipv4Address remoteHost("1.0.0.2");
+    const Ipv4Address pgwS5("14.0.0.5");
+    const Ipv4Address sgwS5("14.0.0.6");
+    const Ipv4Address sgwS1u("10.0.0.5");
+    const Ipv4Address enbS1u("10.0.0.6");
+    const uint32_t firstUe = Ipv4Address("7.0.0.2").Get();
+
+    // PGW: UE address -> S5 TEID, SGW: S5 TEID -> S1-U TEID,
+    // eNB: S1-U TEID -> (RNTI, bearer id)
+    Table pgw(bearers);
+    Table sgw(bearers);
+    Table enb(bearers);
+    for (uint32_t i = 0; i < bearers; i++)
+    {
+        pgw.Insert(firstUe + i, i + 1);
+        sgw.Insert(i + 1, bearers + i + 1);
+        enb.Insert(bearers + i + 1, ((i + 1) << 8) | 3);
+    }
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+    std::vector<uint32_t> destinations(packets);
+    for (auto& d : destinations)
+    {
+        d = rv->GetInteger(0, bearers - 1);
+    }
+
+    checksum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < packets; n++)
+    {
+        // Remote host
+        Ptr<Packet> p = Create<Packet>(payloadSize);
+        UdpHeader udp;
+        udp.SetSourcePort(49153);
+        udp.SetDestinationPort(10001);
+        p->AddHeader(udp);
+        SendIpv4(p, remoteHost, Ipv4Address(firstUe + destinations[n]),
+                 UdpL4Protocol::PROT_NUMBER);
+
+        // PGW: SGi to TUN device, tunnel towards the SGW
+        Ipv4Header ip;
+        p = ReceiveIpv4(p, ip);
+        p->AddHeader(ip);
+        uint32_t teid = pgw.Find(ip.GetDestination().Get());
+        SendGtpu(p, teid, pgwS5, sgwS5);
+
+        // SGW: tunnel towards the eNB
+        p = ReceiveGtpu(p, teid);
+        SendGtpu(p, sgw.Find(teid), sgwS1u, enbS1u);
+
+        // eNB: radio bearer of the tunnel
+        p = ReceiveGtpu(p, teid);
+        checksum += enb.Find(teid) + p->GetSize();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double nsPerPacket = std::chrono::duration<double, std::nano>(end - begin).count() / packets;
+
+    uint64_t sum = 0;
+    begin = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < packets; n++)
+    {
+        sum += enb.Find(sgw.Find(pgw.Find(firstUe + destinations[n])));
+    }
+    end = std::chrono::steady_clock::now();
+    nsPerLookup = std::chrono::duration<double, std::nano>(end - begin).count() / packets / 3;
+    g_lookupSink += sum;
+    return nsPerPacket;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string bearersList = "100,10000,100000";
+    uint32_t packets = 1000000;
+    uint32_t payloadSize = 1500;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("bearers", "Comma separated numbers of UEs with one bearer each", bearersList);
+    cmd.AddValue("packets", "Number of packets per run", packets);
+    cmd.AddValue("payloadSize", "UDP payload size in bytes", payloadSize);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::left << std::setw(10) << "bearers" << std::setw(8) << "table"
+              << std::setw(14) << "ns/packet" << std::setw(14) << "ns/lookup"
+              << "checksum" << std::endl;
+
+    std::istringstream iss(bearersList);
+    std::string token;
+    bool sameResult = true;
+    while (std::getline(iss, token, ','))
+    {
+        uint32_t bearers = std::stoul(token);
+        double mapLookup;
+        double flatLookup;
+        uint64_t mapChecksum;
+        uint64_t flatChecksum;
+        double mapPacket =
+            RunPath<MapTable>(bearers, packets, payloadSize, mapLookup, mapChecksum);
+        double flatPacket =
+            RunPath<FlatTable>(bearers, packets, payloadSize, flatLookup, flatChecksum);
+        bool ok = mapChecksum == flatChecksum;
+        sameResult = sameResult && ok;
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << std::left << std::setw(10) << bearers << std::setw(8) << "map"
+                  << std::setw(14) << mapPacket << std::setw(14) << mapLookup << "-"
+                  << std::endl;
+        std::cout << std::left << std::setw(10) << bearers << std::setw(8) << "flat"
+                  << std::setw(14) << flatPacket << std::setw(14) << flatLookup
+                  << (ok ? "same" : "DIFFERENT") << std::endl;
+    }
+    Simulator::Destroy();
+    return sameResult ? 0 : 1;
+}
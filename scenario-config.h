@@ -0,0 +1,251 @@
+#ifndef SCENARIO_CONFIG_H
+#define SCENARIO_CONFIG_H
+
+#include <ns3/core-module.h>
+
+#include <fstream>
+#include <functional>
+#include <map>
+
+namespace ns3
+{
+
+/**
+ * Scenario settings read from an INI file and from the command line.
+ *
+ * Every setting is registered once with Add(), which binds it to a variable
+ * of the scenario and to a CommandLine argument of the same name. Parse()
+ * first loads the file given with --config, then applies the other
+ * arguments, so that
+ *
+ *   ./ns3 run "lte-scenario --config=scratch/parta.ini --numUes=200"
+ *
+ * runs the parta preset with 200 UEs. In the file, sections only group the
+ * settings (their names are unique across sections), except [ns3], whose
+ * keys are attribute names passed to Config::SetDefault:
+ *
+ *   [traffic]
+ *   ulTraffic = true
+ *
+ *   [ns3]
+ *   ns3::LteUePhy::TxPower = 20
+ */
+class ScenarioConfig
+{
+  public:
+    /**
+     * \param programName The program name, for the command line usage.
+     */
+    ScenarioConfig(const std::string& programName)
+        : m_cmd(programName)
+    {
+    }
+
+    /**
+     * Register a setting.
+     *
+     * \param name The setting name, in the file and on the command line.
+     * \param help The help text.
+     * \param value The variable holding the setting, with its default value.
+     */
+    template <typename T>
+    void Add(const std::string& name, const std::string& help, T& value)
+    {
+        m_cmd.AddValue(name, help, value);
+        m_names.push_back(name);
+        m_setters[name] = [&value, name](const std::string& text) {
+            NS_ABORT_MSG_IF(!FromString(text, value),
+                            "Invalid value \"" << text << "\" for " << name);
+        };
+        m_getters[name] = [&value]() {
+            std::ostringstream oss;
+            oss << std::boolalpha << value;
+            return oss.str();
+        };
+    }
+
+    /**
+     * Load the file given with --config, if any, then the other arguments.
+     *
+     * \param argc The argument count.
+     * \param argv The arguments.
+     */
+    void Parse(int argc, char* argv[])
+    {
+        std::string configFile;
+        m_cmd.AddValue("config",
+                       "INI file with the scenario settings, which the other arguments override",
+                       configFile);
+        // The file has to be loaded before CommandLine applies the overrides
+        const std::string prefix = "--config=";
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg.compare(0, prefix.size(), prefix) == 0)
+            {
+                configFile = arg.substr(prefix.size());
+            }
+        }
+        if (!configFile.empty())
+        {
+            Load(configFile);
+        }
+        m_cmd.Parse(argc, argv);
+    }
+
+    /**
+     * Print the value of every setting, in the INI format.
+     * \param os The output stream.
+     */
+    void Print(std::ostream& os) const
+    {
+        for (const auto& name : m_names)
+        {
+            os << name << " = " << m_getters.at(name)() << std::endl;
+        }
+    }
+
+    /**
+     * Split a comma separated list.
+     * \param list The list.
+     * \return The items, without surrounding blanks.
+     */
+    static std::vector<std::string> Split(const std::string& list)
+    {
+        std::vector<std::string> items;
+        std::istringstream iss(list);
+        std::string item;
+        while (std::getline(iss, item, ','))
+        {
+            item = Trim(item);
+            if (!item.empty())
+            {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+  private:
+    /// Parses the text of a setting into its variable
+    typedef std::function<void(const std::string&)> Setter;
+    /// Prints the value of a setting
+    typedef std::function<std::string()> Getter;
+
+    /**
+     * Load an INI file.
+     * \param fileName The file name.
+     */
+    void Load(const std::string& fileName)
+    {
+        std::ifstream in(fileName);
+        NS_ABORT_MSG_IF(!in.is_open(), "Cannot open " << fileName);
+        std::string section;
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline(in, line))
+        {
+            lineNumber++;
+            line = Trim(line);
+            if (line.empty() || line[0] == ';' || line[0] == '#')
+            {
+                continue;
+            }
+            if (line[0] == '[')
+            {
+                NS_ABORT_MSG_IF(line.back() != ']',
+                                fileName << ":" << lineNumber << ": invalid section header");
+                section = Trim(line.substr(1, line.size() - 2));
+                continue;
+            }
+            size_t eq = line.find('=');
+            NS_ABORT_MSG_IF(eq == std::string::npos,
+                            fileName << ":" << lineNumber << ": expected key = value");
+            std::string key = Trim(line.substr(0, eq));
+            std::string value = Trim(line.substr(eq + 1));
+            if (section == "ns3")
+            {
+                Config::SetDefault(key, StringValue(value));
+                continue;
+            }
+            auto it = m_setters.find(key);
+            NS_ABORT_MSG_IF(it == m_setters.end(),
+                            fileName << ":" << lineNumber << ": unknown setting " << key);
+            it->second(value);
+        }
+    }
+
+    /**
+     * \param text A string.
+     * \return The string without leading and trailing blanks.
+     */
+    static std::string Trim(const std::string& text)
+    {
+        size_t first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+        {
+            return "";
+        }
+        size_t last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    /**
+     * \param text The text of a value.
+     * \param [out] value The parsed value.
+     * \return Whether the text is valid.
+     */
+    template <typename T>
+    static bool FromString(const std::string& text, T& value)
+    {
+        std::istringstream iss(text);
+        T parsed;
+        iss >> parsed;
+        if (iss.fail() || !(iss >> std::ws).eof())
+        {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    /**
+     * \param text The text of a string value, kept whole.
+     * \param [out] value The value.
+     * \return True.
+     */
+    static bool FromString(const std::string& text, std::string& value)
+    {
+        value = text;
+        return true;
+    }
+
+    /**
+     * \param text The text of a boolean value.
+     * \param [out] value The parsed value.
+     * \return Whether the text is one of true, false, 1 or 0.
+     */
+    static bool FromString(const std::string& text, bool& value)
+    {
+        if (text == "true" || text == "1")
+        {
+            value = true;
+            return true;
+        }
+        if (text == "false" || text == "0")
+        {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+
+    CommandLine m_cmd;                       //!< Command line parser
+    std::vector<std::string> m_names;        //!< Setting names, in registration order
+    std::map<std::string, Setter> m_setters; //!< Parser of each setting
+    std::map<std::string, Getter> m_getters; //!< Printer of each setting
+};
+
+} // namespace ns3
+
+#endif // SCENARIO_CONFIG_H
@@ -0,0 +1,260 @@
+#include "tti-calendar-scheduler.h"
+
+#include "ns3/core-module.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+
+/*
+ * Compares Simulator::Run() with the standard schedulers and the TTI calendar
+ * scheduler on an LTE-like event pattern: every pending event is a periodic
+ * timer (UdpClient intervals, subframe indications, SRS/CQI periods), most of
+ * them aligned to 1 ms TTI boundaries. The number of pending events stays
+ * constant during the run, and the order in which events were dispatched is
+ * folded into a checksum that must be identical for all schedulers.
+ *
+ * This synthetic workload only isolates the scheduler: it has none of the
+ * cancelled events, the bursts of events per TTI and the cache footprint of
+ * the LTE models. With --program=<lte-scenario executable>, the benchmark
+ * instead runs lte-scenario on each preset of --presets with schedulerType
+ * set to each scheduler, in workDir/<preset>_<scheduler>/, and compares the
+ * time of their Simulator::Run(); the events executed must be the same.
+ */
+
+uint64_t g_checksum = 0; //!< Dispatch order checksum
+uint64_t g_executed = 0; //!< Number of executed events
+
+/**
+ * A periodic timer firing every period.
+ *
+ * \param id Identifier of the timer.
+ * \param period Timer period.
+ */
+void PeriodicEvent(uint32_t id, Time period)
+{
+    g_checksum = g_checksum * 1099511628211ULL + id;
+    g_executed++;
+    Simulator::Schedule(period, &PeriodicEvent, id, period);
+}
+
+/**
+ * Run the LTE-like workload with one scheduler.
+ *
+ * \param schedulerType TypeId name of the scheduler.
+ * \param pending Number of pending events.
+ * \param simTime Simulated duration.
+ * \return The wall clock duration of Simulator::Run() in seconds.
+ */
+double RunWorkload(std::string schedulerType, uint32_t pending, Time simTime)
+{
+    ObjectFactory factory;
+    factory.SetTypeId(schedulerType);
+    Simulator::SetScheduler(factory);
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    const Time periods[] = {MilliSeconds(1), MilliSeconds(1), MilliSeconds(1), MilliSeconds(1),
+                            MilliSeconds(2), MilliSeconds(10), MilliSeconds(40), MilliSeconds(200)};
+    for (uint32_t i = 0; i < pending; i++)
+    {
+        Time period = periods[rv->GetInteger(0, 7)];
+        // Most timers start on a TTI boundary, the rest inside the subframe
+        Time start = MilliSeconds(rv->GetInteger(0, period.GetMilliSeconds() - 1));
+        if (rv->GetValue() < 0.2)
+        {
+            start += MicroSeconds(rv->GetInteger(1, 999));
+        }
+        Simulator::Schedule(start, &PeriodicEvent, i, period);
+    }
+
+    g_checksum = 0;
+    g_executed = 0;
+    Simulator::Stop(simTime);
+    auto begin = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto end = std::chrono::steady_clock::now();
+    Simulator::Destroy();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+/**
+ * Run lte-scenario once in a directory.
+ *
+ * \param program The lte-scenario executable.
+ * \param args Its arguments.
+ * \param dir The run directory, where its output goes to output.txt.
+ * \param[out] events The events executed.
+ * \return The wall clock duration of its Simulator::Run() in seconds.
+ */
+double RunScenario(const std::string& program,
+                   const std::vector<std::string>& args,
+                   const std::string& dir,
+                   uint64_t& events)
+{
+    pid_t pid = fork();
+    NS_ABORT_MSG_IF(pid < 0, "Cannot fork " << program);
+    if (pid == 0)
+    {
+        if (chdir(dir.c_str()) != 0 || !std::freopen("output.txt", "w", stdout) ||
+            dup2(fileno(stdout), STDERR_FILENO) < 0)
+        {
+            _exit(127);
+        }
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(program.c_str()));
+        for (const auto& arg : args)
+        {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        execv(program.c_str(), argv.data());
+        _exit(127);
+    }
+    int status = 0;
+    NS_ABORT_MSG_IF(waitpid(pid, &status, 0) != pid, "Lost the run in " << dir);
+    NS_ABORT_MSG_IF(!WIFEXITED(status) || WEXITSTATUS(status) != 0,
+                    program << " failed in " << dir << ", see " << dir << "/output.txt");
+
+    // The Simulator::Run() phase of the setup timer and the event count
+    std::ifstream output(dir + "/output.txt");
+    std::string line;
+    double runTime = 0;
+    events = 0;
+    while (std::getline(output, line))
+    {
+        std::istringstream iss(line);
+        std::string word;
+        iss >> word;
+        if (word == "Simulator::Run")
+        {
+            iss >> runTime;
+        }
+        else if (line.rfind("Events executed:", 0) == 0)
+        {
+            events = std::stoull(line.substr(16));
+        }
+    }
+    NS_ABORT_MSG_IF(runTime <= 0 || events == 0,
+                    "No run time or event count in " << dir << "/output.txt");
+    return runTime;
+}
+
+/**
+ * \param path A path.
+ * \return The path, made absolute from the working directory.
+ */
+std::string AbsolutePath(const std::string& path)
+{
+    if (path.empty() || path[0] == '/')
+    {
+        return path;
+    }
+    char* cwd = getcwd(nullptr, 0);
+    std::string absolute = std::string(cwd) + "/" + path;
+    free(cwd);
+    return absolute;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string pendingList = "1000,10000,50000";
+    double simTime = 2.0;
+    std::string program = "";
+    std::string presetList = "new-lte.ini,parta.ini,parta_old.ini,lte.ini";
+    std::string scenarioSimTime = "2s";
+    std::string workDir = "scheduler-runs";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("pending", "Comma separated numbers of pending events", pendingList);
+    cmd.AddValue("simTime", "Simulated time per run in seconds", simTime);
+    cmd.AddValue("program", "lte-scenario executable, to time its presets instead", program);
+    cmd.AddValue("presets", "Comma separated lte-scenario INI files", presetList);
+    cmd.AddValue("scenarioSimTime", "simTime of the lte-scenario runs", scenarioSimTime);
+    cmd.AddValue("workDir", "Directory of the lte-scenario runs", workDir);
+    cmd.Parse(argc, argv);
+
+    const std::string schedulers[] = {"ns3::MapScheduler",
+                                      "ns3::HeapScheduler",
+                                      "ns3::CalendarScheduler",
+                                      "ns3::TtiCalendarScheduler"};
+
+    if (!program.empty())
+    {
+        // The runs happen in their own directories
+        program = AbsolutePath(program);
+        NS_ABORT_MSG_IF(mkdir(workDir.c_str(), 0755) != 0 && errno != EEXIST,
+                        "Cannot create " << workDir);
+        std::cout << std::left << std::setw(20) << "preset" << std::setw(28) << "scheduler"
+                  << std::setw(12) << "run [s]" << std::setw(14) << "events/s"
+                  << "events" << std::endl;
+        std::istringstream presets(presetList);
+        std::string preset;
+        bool sameEvents = true;
+        while (std::getline(presets, preset, ','))
+        {
+            uint64_t referenceEvents = 0;
+            for (const auto& scheduler : schedulers)
+            {
+                std::string dir = workDir + "/" + preset + "_" + scheduler.substr(5);
+                NS_ABORT_MSG_IF(mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST,
+                                "Cannot create " << dir);
+                uint64_t events = 0;
+                double runTime = RunScenario(program,
+                                             {"--config=" + AbsolutePath(preset),
+                                              "--schedulerType=" + scheduler,
+                                              "--simTime=" + scenarioSimTime},
+                                             dir,
+                                             events);
+                if (scheduler == schedulers[0])
+                {
+                    referenceEvents = events;
+                }
+                bool ok = events == referenceEvents;
+                sameEvents = sameEvents && ok;
+                std::cout << std::left << std::setw(20) << preset << std::setw(28) << scheduler
+                          << std::setw(12) << std::fixed << std::setprecision(3) << runTime
+                          << std::setw(14) << std::setprecision(0) << events / runTime << events
+                          << (ok ? "" : " DIFFERENT") << std::endl;
+            }
+        }
+        return sameEvents ? 0 : 1;
+    }
+
+    std::cout << std::left << std::setw(10) << "pending" << std::setw(28) << "scheduler"
+              << std::setw(12) << "wall [s]" << std::setw(14) << "events/s"
+              << "order" << std::endl;
+
+    std::istringstream iss(pendingList);
+    std::string token;
+    bool sameOrder = true;
+    while (std::getline(iss, token, ','))
+    {
+        uint32_t pending = std::stoul(token);
+        uint64_t referenceChecksum = 0;
+        for (const auto& scheduler : schedulers)
+        {
+            double wall = RunWorkload(scheduler, pending, Seconds(simTime));
+            if (scheduler == schedulers[0])
+            {
+                referenceChecksum = g_checksum;
+            }
+            bool ok = g_checksum == referenceChecksum;
+            sameOrder = sameOrder && ok;
+            std::cout << std::left << std::setw(10) << pending << std::setw(28) << scheduler
+                      << std::setw(12) << std::fixed << std::setprecision(3) << wall
+                      << std::setw(14) << std::setprecision(0) << g_executed / wall
+                      << (ok ? "same" : "DIFFERENT") << std::endl;
+        }
+    }
+    return sameOrder ? 0 : 1;
+}
@@ -0,0 +1,350 @@
+#include "recording-ff-mac-scheduler.h"
+
+#include "ns3/core-module.h"
+#include "ns3/lte-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <unordered_map>
+
+using namespace ns3;
+
+/*
+ * Feeds the scheduler input logs that lte-scenario writes with schedulerLog
+ * set to FF MAC schedulers, without PHY, channel or EPC. Each scheduler
+ * gets, cell by cell, the recorded RLC buffer, CQI, BSR, RACH and HARQ
+ * inputs at full speed, and the allocations it answers with are summed up:
+ *
+ *   ./ns3 run "scheduler-replay --logs=sched_1.bin,sched_2.bin
+ *              --schedulers=ns3::RrFfMacScheduler,ns3::PfFfMacScheduler"
+ *
+ * The replay is open loop: the buffer status and CQI reports are those of
+ * the recorded run, whatever the replayed scheduler allocates, so it
+ * compares schedulers on the same traffic and channel, not the TCP or RLC
+ * reaction to them. The HARQ feedback only makes sense for the processes
+ * the replayed scheduler used: with harq=false (the default) the schedulers
+ * run without HARQ and ignore it, with harq=true it is only passed for the
+ * DL processes and UL grants the replayed scheduler has in flight.
+ */
+
+/// Allocations of the replayed schedulers, over all cells
+struct ReplayStats
+{
+    uint64_t ttis = 0;                    //!< Replayed TTIs
+    uint64_t dlBytes = 0;                 //!< New DL transport block bytes
+    uint64_t dlRetxBytes = 0;             //!< Retransmitted DL bytes
+    uint64_t ulBytes = 0;                 //!< New UL transport block bytes
+    std::map<uint32_t, uint64_t> ueBytes; //!< New DL bytes per configured (cell, RNTI)
+};
+
+/**
+ * Feeds the records of one cell to a scheduler and collects its allocations.
+ */
+class ScheduleReplayer : public FfMacSchedSapUser, public FfMacCschedSapUser
+{
+  public:
+    /**
+     * \param schedulerType TypeId of the scheduler.
+     * \param cellId Cell of the log.
+     * \param harq Whether HARQ is enabled and the feedback replayed.
+     * \param stats Statistics to add the allocations to.
+     */
+    ScheduleReplayer(const std::string& schedulerType,
+                     uint16_t cellId,
+                     bool harq,
+                     ReplayStats& stats)
+        : m_cellId(cellId),
+          m_harq(harq),
+          m_stats(stats)
+    {
+        ObjectFactory factory(schedulerType);
+        factory.Set("HarqEnabled", BooleanValue(harq));
+        m_scheduler = factory.Create<FfMacScheduler>();
+        NS_ABORT_MSG_IF(!m_scheduler, schedulerType << " is not an FF MAC scheduler");
+        m_ffr = CreateObject<LteFrNoOpAlgorithm>();
+        m_scheduler->SetFfMacSchedSapUser(this);
+        m_scheduler->SetFfMacCschedSapUser(this);
+        m_scheduler->SetLteFfrSapProvider(m_ffr->GetLteFfrSapProvider());
+        m_ffr->SetLteFfrSapUser(m_scheduler->GetLteFfrSapUser());
+        m_sched = m_scheduler->GetFfMacSchedSapProvider();
+        m_csched = m_scheduler->GetFfMacCschedSapProvider();
+    }
+
+    ~ScheduleReplayer() override
+    {
+        m_scheduler->Dispose();
+        m_ffr->Dispose();
+    }
+
+    /**
+     * Replay records.
+     *
+     * \param records The records of the cell.
+     * \return The wall clock time of the replay, in s.
+     */
+    double Run(const std::vector<FfMacLogReader::Record>& records)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        for (const auto& record : records)
+        {
+            std::visit([this](const auto& params) { Feed(params); }, record);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    void SchedDlConfigInd(const SchedDlConfigIndParameters& params) override
+    {
+        for (const auto& data : params.m_buildDataList)
+        {
+            const DlDciListElement_s& dci = data.m_dci;
+            for (size_t tb = 0; tb < dci.m_tbsSize.size(); tb++)
+            {
+                if (dci.m_ndi.at(tb) == 1)
+                {
+                    m_stats.dlBytes += dci.m_tbsSize[tb];
+                    m_stats.ueBytes[(uint32_t(m_cellId) << 16) | data.m_rnti] +=
+                        dci.m_tbsSize[tb];
+                }
+                else
+                {
+                    m_stats.dlRetxBytes += dci.m_tbsSize[tb];
+                }
+            }
+            m_dlHarqInFlight[data.m_rnti] |= 1 << dci.m_harqProcess;
+        }
+    }
+
+    void SchedUlConfigInd(const SchedUlConfigIndParameters& params) override
+    {
+        for (const auto& dci : params.m_dciList)
+        {
+            if (dci.m_ndi == 1)
+            {
+                m_stats.ulBytes += dci.m_tbSize;
+            }
+            m_ulGrantsInFlight[dci.m_rnti]++;
+        }
+    }
+
+    void CschedCellConfigCnf(const CschedCellConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeConfigCnf(const CschedUeConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedLcConfigCnf(const CschedLcConfigCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedLcReleaseCnf(const CschedLcReleaseCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeReleaseCnf(const CschedUeReleaseCnfParameters& /* params */) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(const CschedUeConfigUpdateIndParameters& /* params */) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        const CschedCellConfigUpdateIndParameters& /* params */) override
+    {
+    }
+
+  private:
+    /// \param p The cell configuration, also given to the FFR algorithm.
+    void Feed(const FfMacCschedSapProvider::CschedCellConfigReqParameters& p)
+    {
+        m_ffr->SetUlBandwidth(p.m_ulBandwidth);
+        m_ffr->SetDlBandwidth(p.m_dlBandwidth);
+        m_csched->CschedCellConfigReq(p);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacCschedSapProvider::CschedUeConfigReqParameters& p)
+    {
+        // A UE the scheduler never serves still counts in the fairness
+        m_stats.ueBytes.emplace((uint32_t(m_cellId) << 16) | p.m_rnti, 0);
+        m_csched->CschedUeConfigReq(p);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacCschedSapProvider::CschedLcConfigReqParameters& p)
+    {
+        m_csched->CschedLcConfigReq(p);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacCschedSapProvider::CschedLcReleaseReqParameters& p)
+    {
+        m_csched->CschedLcReleaseReq(p);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacCschedSapProvider::CschedUeReleaseReqParameters& p)
+    {
+        m_dlHarqInFlight.erase(p.m_rnti);
+        m_ulGrantsInFlight.erase(p.m_rnti);
+        m_csched->CschedUeReleaseReq(p);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& p)
+    {
+        m_sched->SchedDlRlcBufferReq(p);
+    }
+
+    /// \param p The trigger, without the feedback of the idle HARQ processes.
+    void Feed(const FfMacSchedSapProvider::SchedDlTriggerReqParameters& p)
+    {
+        m_stats.ttis++;
+        if (!m_harq || p.m_dlInfoList.empty())
+        {
+            m_sched->SchedDlTriggerReq(p);
+            return;
+        }
+        FfMacSchedSapProvider::SchedDlTriggerReqParameters filtered = p;
+        filtered.m_dlInfoList.clear();
+        for (const auto& info : p.m_dlInfoList)
+        {
+            uint8_t& inFlight = m_dlHarqInFlight[info.m_rnti];
+            if (inFlight & (1 << info.m_harqProcessId))
+            {
+                filtered.m_dlInfoList.push_back(info);
+                if (std::all_of(info.m_harqStatus.begin(),
+                                info.m_harqStatus.end(),
+                                [](DlInfoListElement_s::HarqStatus_e s) {
+                                    return s == DlInfoListElement_s::ACK;
+                                }))
+                {
+                    inFlight &= ~(1 << info.m_harqProcessId);
+                }
+            }
+        }
+        m_sched->SchedDlTriggerReq(filtered);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacSchedSapProvider::SchedDlRachInfoReqParameters& p)
+    {
+        m_sched->SchedDlRachInfoReq(p);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& p)
+    {
+        m_sched->SchedDlCqiInfoReq(p);
+    }
+
+    /// \param p The trigger, without the reception status of UEs with no grant.
+    void Feed(const FfMacSchedSapProvider::SchedUlTriggerReqParameters& p)
+    {
+        if (!m_harq || p.m_ulInfoList.empty())
+        {
+            m_sched->SchedUlTriggerReq(p);
+            return;
+        }
+        FfMacSchedSapProvider::SchedUlTriggerReqParameters filtered = p;
+        filtered.m_ulInfoList.clear();
+        for (const auto& info : p.m_ulInfoList)
+        {
+            uint32_t& inFlight = m_ulGrantsInFlight[info.m_rnti];
+            if (inFlight > 0)
+            {
+                filtered.m_ulInfoList.push_back(info);
+                inFlight--;
+            }
+        }
+        m_sched->SchedUlTriggerReq(filtered);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& p)
+    {
+        m_sched->SchedUlMacCtrlInfoReq(p);
+    }
+
+    /// \param p The request.
+    void Feed(const FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& p)
+    {
+        m_sched->SchedUlCqiInfoReq(p);
+    }
+
+    uint16_t m_cellId;                                         //!< Cell of the log
+    bool m_harq;                                               //!< HARQ replayed
+    ReplayStats& m_stats;                                      //!< Allocation statistics
+    Ptr<FfMacScheduler> m_scheduler;                           //!< Replayed scheduler
+    Ptr<LteFfrAlgorithm> m_ffr;                                //!< No-op FFR algorithm
+    FfMacSchedSapProvider* m_sched;                            //!< SCHED SAP of m_scheduler
+    FfMacCschedSapProvider* m_csched;                          //!< CSCHED SAP of m_scheduler
+    std::unordered_map<uint16_t, uint8_t> m_dlHarqInFlight;    //!< DL HARQ processes per RNTI
+    std::unordered_map<uint16_t, uint32_t> m_ulGrantsInFlight; //!< UL grants per RNTI
+};
+
+int main(int argc, char *argv[])
+{
+    std::string logs = "";
+    std::string schedulers = "ns3::RrFfMacScheduler,ns3::PfFfMacScheduler";
+    bool harq = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("logs", "Comma separated scheduler logs, one per cell", logs);
+    cmd.AddValue("schedulers", "Comma separated FF MAC scheduler TypeIds", schedulers);
+    cmd.AddValue("harq", "Run the schedulers with HARQ and replay the HARQ feedback", harq);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(logs.empty(), "No scheduler log given, see --logs");
+
+    std::vector<std::pair<uint16_t, std::vector<FfMacLogReader::Record>>> cells;
+    uint64_t numRecords = 0;
+    std::istringstream logList(logs);
+    std::string fileName;
+    while (std::getline(logList, fileName, ','))
+    {
+        uint16_t cellId = 0;
+        auto records = FfMacLogReader::Load(fileName, cellId);
+        numRecords += records.size();
+        cells.emplace_back(cellId, std::move(records));
+    }
+    std::cout << cells.size() << " cells, " << numRecords << " records" << std::endl;
+
+    std::cout << std::left << std::setw(28) << "scheduler" << std::setw(10) << "TTIs"
+              << std::setw(10) << "us/TTI" << std::setw(10) << "DL Mb/s" << std::setw(12)
+              << "DL retx Mb/s" << std::setw(10) << "UL Mb/s" << "DL Jain" << std::endl;
+    std::istringstream schedulerList(schedulers);
+    std::string schedulerType;
+    while (std::getline(schedulerList, schedulerType, ','))
+    {
+        ReplayStats stats;
+        double seconds = 0;
+        for (const auto& cell : cells)
+        {
+            ScheduleReplayer replayer(schedulerType, cell.first, harq, stats);
+            seconds += replayer.Run(cell.second);
+        }
+
+        // Jain's fairness index of the DL bytes of every configured UE
+        double sum = 0;
+        double sumSquares = 0;
+        for (const auto& ue : stats.ueBytes)
+        {
+            sum += ue.second;
+            sumSquares += double(ue.second) * ue.second;
+        }
+        double jain = sumSquares > 0 ? sum * sum / (stats.ueBytes.size() * sumSquares) : 0;
+        // TTIs are summed over the cells, so the rates are per cell
+        double mbps = stats.ttis > 0 ? 8e-3 / stats.ttis : 0;
+        std::cout << std::left << std::setw(28) << schedulerType << std::setw(10) << stats.ttis
+                  << std::setw(10) << std::fixed << std::setprecision(2)
+                  << (stats.ttis > 0 ? seconds * 1e6 / stats.ttis : 0) << std::setw(10)
+                  << stats.dlBytes * mbps << std::setw(12) << stats.dlRetxBytes * mbps
+                  << std::setw(10) << stats.ulBytes * mbps << std::setprecision(3) << jain
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,433 @@
+#ifndef SHARD_INTERFERENCE_EXCHANGE_H
+#define SHARD_INTERFERENCE_EXCHANGE_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/spectrum-module.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * Header of the shared memory segment of a sharded run.
+ *
+ * It is followed by numEnbs x DEPTH x numRbs floats: for each eNB of the
+ * whole deployment, the downlink PSD (W/Hz per RB, averaged over the TTI) of
+ * its last DEPTH TTIs, slot tti % DEPTH. Only the eNBs that are a ghost in
+ * some other shard are written.
+ */
+struct ShardSegmentHeader
+{
+    static constexpr uint32_t MAX_SHARDS = 64; //!< Largest number of shards
+    static constexpr uint32_t DEPTH = 4;       //!< TTIs kept per eNB
+
+    char magic[8];                              //!< "LTESHRD1"
+    uint32_t numShards;                         //!< Number of shards
+    uint32_t numEnbs;                           //!< eNBs of the whole deployment
+    uint32_t numRbs;                            //!< Downlink RBs
+    uint32_t reserved;                          //!< Padding, always 0
+    std::atomic<int64_t> published[MAX_SHARDS]; //!< Last TTI written per shard, -1 none
+    std::atomic<uint32_t> finished[MAX_SHARDS]; //!< 1 once the shard stopped
+};
+
+/**
+ * Transmit-only spectrum PHY standing for an eNB simulated by another shard.
+ * It is never a receiver of the channel.
+ */
+class GhostEnbSpectrumPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::GhostEnbSpectrumPhy")
+                                .SetParent<SpectrumPhy>()
+                                .AddConstructor<GhostEnbSpectrumPhy>();
+        return tid;
+    }
+
+    void SetDevice(Ptr<NetDevice> /* d */) override
+    {
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return nullptr;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel> /* c */) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return nullptr;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return nullptr;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> /* params */) override
+    {
+    }
+
+  protected:
+    void DoDispose() override
+    {
+        m_mobility = nullptr;
+        SpectrumPhy::DoDispose();
+    }
+
+  private:
+    Ptr<MobilityModel> m_mobility; //!< Position of the remote eNB
+};
+
+NS_OBJECT_ENSURE_REGISTERED(GhostEnbSpectrumPhy);
+
+/**
+ * Exchanges the downlink interference of the border eNBs between the
+ * processes (shards) of a geographically partitioned run.
+ *
+ * Every shard simulates the full LTE stack of its own eNBs and UEs only. The
+ * eNBs of the other shards close enough to interfere are ghosts: transmit-only
+ * PHYs at their position, which every TTI send on the local downlink channel
+ * the PSD their real eNB transmitted one TTI earlier. The UEs see it as non
+ * LTE interference, through the usual pathloss and fading.
+ *
+ * At the start of TTI t, a shard writes the PSD of its border eNBs for TTI
+ * t-1, averaged over the TTI, then waits until every shard it has ghosts of
+ * wrote TTI t-1 too, and sends its ghosts. The one TTI lag is the lookahead
+ * that lets the shards run in lockstep without rollbacks, and since a ghost
+ * always carries the same TTI of its eNB, a seed gives the same results
+ * whatever the relative speed of the processes.
+ *
+ * The shards end their setup at different times, so the first TTI is a
+ * barrier without time limit: every shard waits until all of them wrote
+ * TTI 0. From then on, a shard not reaching a TTI within the timeout is
+ * taken as failed. Once a shard finished, its ghosts stop transmitting.
+ */
+class ShardInterferenceExchange
+{
+  public:
+    /**
+     * Create and initialize the segment, before the shards start.
+     *
+     * \param shmName Name of the POSIX shared memory segment.
+     * \param numShards Number of shards.
+     * \param numEnbs eNBs of the whole deployment.
+     * \param numRbs Downlink RBs.
+     */
+    static void CreateSegment(const std::string& shmName,
+                              uint32_t numShards,
+                              uint32_t numEnbs,
+                              uint32_t numRbs)
+    {
+        NS_ABORT_MSG_IF(numShards > ShardSegmentHeader::MAX_SHARDS,
+                        "At most " << ShardSegmentHeader::MAX_SHARDS << " shards");
+        size_t length = SegmentLength(numEnbs, numRbs);
+        int fd = shm_open(shmName.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+        NS_ABORT_MSG_IF(fd < 0, "Cannot create shared memory segment " << shmName);
+        NS_ABORT_MSG_IF(ftruncate(fd, static_cast<off_t>(length)) != 0,
+                        "Cannot size shared memory segment " << shmName);
+        void* addr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        NS_ABORT_MSG_IF(addr == MAP_FAILED, "Cannot map shared memory segment " << shmName);
+
+        auto* header = new (addr) ShardSegmentHeader;
+        std::memcpy(header->magic, "LTESHRD1", sizeof(header->magic));
+        header->numShards = numShards;
+        header->numEnbs = numEnbs;
+        header->numRbs = numRbs;
+        header->reserved = 0;
+        for (uint32_t s = 0; s < ShardSegmentHeader::MAX_SHARDS; s++)
+        {
+            header->published[s].store(-1);
+            header->finished[s].store(0);
+        }
+        munmap(addr, length);
+    }
+
+    /**
+     * \param shmName Name of a segment made by CreateSegment().
+     * \param shard Index of this shard.
+     */
+    ShardInterferenceExchange(const std::string& shmName, uint32_t shard)
+        : m_shard(shard),
+          m_timeout(Seconds(60))
+    {
+        int fd = shm_open(shmName.c_str(), O_RDWR, 0);
+        NS_ABORT_MSG_IF(fd < 0, "No shared memory segment " << shmName);
+        struct stat st;
+        NS_ABORT_MSG_IF(fstat(fd, &st) != 0, "Cannot stat shared memory segment " << shmName);
+        m_mapLength = st.st_size;
+        void* addr = mmap(nullptr, m_mapLength, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        NS_ABORT_MSG_IF(addr == MAP_FAILED, "Cannot map shared memory segment " << shmName);
+        m_header = static_cast<ShardSegmentHeader*>(addr);
+        NS_ABORT_MSG_IF(std::memcmp(m_header->magic, "LTESHRD1", sizeof(m_header->magic)) != 0 ||
+                            m_mapLength < SegmentLength(m_header->numEnbs, m_header->numRbs),
+                        shmName << " is not a shard segment");
+        NS_ABORT_MSG_IF(shard >= m_header->numShards, "Shard " << shard << " out of range");
+        m_psd = reinterpret_cast<float*>(m_header + 1);
+    }
+
+    ~ShardInterferenceExchange()
+    {
+        Finish();
+        munmap(m_header, m_mapLength);
+    }
+
+    /**
+     * Publish the downlink PSD of a local eNB, for the other shards.
+     *
+     * \param enbIndex Index of the eNB in the whole deployment.
+     * \param enb Its device.
+     */
+    void AddBorderEnb(uint32_t enbIndex, Ptr<LteEnbNetDevice> enb)
+    {
+        NS_ABORT_MSG_IF(enbIndex >= m_header->numEnbs, "eNB " << enbIndex << " out of range");
+        SpectrumPhy* phy = PeekPointer(enb->GetPhy()->GetDownlinkSpectrumPhy());
+        m_borderPhys[phy] = m_borderEnbs.size();
+        m_borderEnbs.push_back(enbIndex);
+    }
+
+    /**
+     * Replay the downlink of an eNB of another shard as interference.
+     *
+     * \param enbIndex Index of the eNB in the whole deployment.
+     * \param shard The shard simulating it.
+     * \param position Its position.
+     */
+    void AddGhostEnb(uint32_t enbIndex, uint32_t shard, Vector position)
+    {
+        NS_ABORT_MSG_IF(enbIndex >= m_header->numEnbs, "eNB " << enbIndex << " out of range");
+        Ghost ghost;
+        ghost.enbIndex = enbIndex;
+        ghost.shard = shard;
+        ghost.phy = CreateObject<GhostEnbSpectrumPhy>();
+        Ptr<ConstantPositionMobilityModel> mobility =
+            CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(position);
+        ghost.phy->SetMobility(mobility);
+        m_ghosts.push_back(ghost);
+        if (std::find(m_peers.begin(), m_peers.end(), shard) == m_peers.end())
+        {
+            m_peers.push_back(shard);
+        }
+    }
+
+    /**
+     * Start the exchange, once the local eNBs are installed.
+     *
+     * \param dlChannel The downlink channel.
+     * \param model Spectrum model of the downlink.
+     */
+    void Start(Ptr<SpectrumChannel> dlChannel, Ptr<const SpectrumModel> model)
+    {
+        NS_ABORT_MSG_IF(model->GetNumBands() != m_header->numRbs,
+                        "The shards do not use " << m_header->numRbs << " RBs");
+        m_channel = dlChannel;
+        m_model = model;
+        for (auto& acc : m_accumulated)
+        {
+            acc.assign(m_borderEnbs.size() * m_header->numRbs, 0.0);
+        }
+        dlChannel->TraceConnectWithoutContext(
+            "TxSigParams",
+            MakeCallback(&ShardInterferenceExchange::TxSignal, this));
+        Simulator::Schedule(MilliSeconds(1), &ShardInterferenceExchange::Tick, this, 1);
+    }
+
+    /**
+     * \param timeout Longest wall-clock wait for a peer after the first TTI.
+     */
+    void SetTimeout(Time timeout)
+    {
+        m_timeout = timeout;
+    }
+
+    /// Let the other shards go on without this one, once Simulator::Run() returned
+    void Finish()
+    {
+        m_header->finished[m_shard].store(1, std::memory_order_release);
+    }
+
+  private:
+    /// An eNB of another shard
+    struct Ghost
+    {
+        uint32_t enbIndex;            //!< Index in the whole deployment
+        uint32_t shard;               //!< Shard simulating the eNB
+        Ptr<GhostEnbSpectrumPhy> phy; //!< Transmitter on the local channel
+    };
+
+    /**
+     * \param numEnbs eNBs of the whole deployment.
+     * \param numRbs Downlink RBs.
+     * \return The size of the segment.
+     */
+    static size_t SegmentLength(uint32_t numEnbs, uint32_t numRbs)
+    {
+        return sizeof(ShardSegmentHeader) +
+               sizeof(float) * numEnbs * ShardSegmentHeader::DEPTH * numRbs;
+    }
+
+    /**
+     * \param enbIndex An eNB index.
+     * \param tti A TTI.
+     * \return The PSD slot of the eNB for the TTI.
+     */
+    float* Slot(uint32_t enbIndex, int64_t tti)
+    {
+        size_t slot = static_cast<size_t>(enbIndex) * ShardSegmentHeader::DEPTH +
+                      tti % ShardSegmentHeader::DEPTH;
+        return m_psd + slot * m_header->numRbs;
+    }
+
+    /**
+     * Add a downlink transmission of a border eNB to the PSD of its TTI.
+     * \param params The signal.
+     */
+    void TxSignal(Ptr<SpectrumSignalParameters> params)
+    {
+        auto it = m_borderPhys.find(PeekPointer(params->txPhy));
+        if (it == m_borderPhys.end())
+        {
+            return;
+        }
+        int64_t tti = Simulator::Now().GetNanoSeconds() / 1000000;
+        double weight = params->duration.GetSeconds() / 1e-3;
+        double* acc = m_accumulated[tti & 1].data() + it->second * m_header->numRbs;
+        for (uint32_t rb = 0; rb < m_header->numRbs; rb++)
+        {
+            acc[rb] += (*params->psd)[rb] * weight;
+        }
+    }
+
+    /**
+     * Wait until a shard wrote a TTI, or stopped.
+     *
+     * \param shard The shard.
+     * \param tti The TTI.
+     * \param bounded Whether to abort after the timeout.
+     */
+    void WaitFor(uint32_t shard, int64_t tti, bool bounded)
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::nanoseconds(m_timeout.GetNanoSeconds());
+        uint32_t spins = 0;
+        while (m_header->published[shard].load(std::memory_order_acquire) < tti &&
+               !m_header->finished[shard].load(std::memory_order_acquire))
+        {
+            if (++spins < 1000)
+            {
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            NS_ABORT_MSG_IF(bounded && std::chrono::steady_clock::now() > deadline,
+                            "Shard " << shard << " did not reach TTI " << tti);
+        }
+    }
+
+    /**
+     * Publish TTI t-1 of the border eNBs and send TTI t-1 of the ghosts.
+     * \param tti The TTI t starting now.
+     */
+    void Tick(int64_t tti)
+    {
+        uint32_t numRbs = m_header->numRbs;
+        std::vector<double>& acc = m_accumulated[(tti - 1) & 1];
+        for (uint32_t i = 0; i < m_borderEnbs.size(); i++)
+        {
+            float* slot = Slot(m_borderEnbs[i], tti - 1);
+            for (uint32_t rb = 0; rb < numRbs; rb++)
+            {
+                slot[rb] = static_cast<float>(acc[i * numRbs + rb]);
+            }
+        }
+        std::fill(acc.begin(), acc.end(), 0.0);
+        m_header->published[m_shard].store(tti - 1, std::memory_order_release);
+
+        if (tti == 1)
+        {
+            // Startup barrier, with every shard and not only the peers: a
+            // peer may itself be waiting for a slow shard
+            for (uint32_t shard = 0; shard < m_header->numShards; shard++)
+            {
+                WaitFor(shard, 0, false);
+            }
+        }
+        for (uint32_t shard : m_peers)
+        {
+            WaitFor(shard, tti - 1, true);
+        }
+        for (const auto& ghost : m_ghosts)
+        {
+            // A shard that stopped before TTI t-1 left older TTIs in its slots
+            if (m_header->published[ghost.shard].load(std::memory_order_acquire) < tti - 1)
+            {
+                continue;
+            }
+            const float* slot = Slot(ghost.enbIndex, tti - 1);
+            if (std::all_of(slot, slot + numRbs, [](float p) { return p == 0; }))
+            {
+                continue; // idle
+            }
+            Ptr<SpectrumValue> psd = Create<SpectrumValue>(m_model);
+            for (uint32_t rb = 0; rb < numRbs; rb++)
+            {
+                (*psd)[rb] = slot[rb];
+            }
+            Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+            params->psd = psd;
+            params->duration = MilliSeconds(1);
+            params->txPhy = ghost.phy;
+            m_channel->StartTx(params);
+        }
+        Simulator::Schedule(MilliSeconds(1), &ShardInterferenceExchange::Tick, this, tti + 1);
+    }
+
+    uint32_t m_shard;                                      //!< This shard
+    Time m_timeout;                                        //!< Longest wait for a peer
+    ShardSegmentHeader* m_header;                          //!< Mapped segment
+    size_t m_mapLength;                                    //!< Mapped length
+    float* m_psd;                                          //!< PSD slots after the header
+    std::vector<uint32_t> m_borderEnbs;                    //!< Published local eNBs
+    std::unordered_map<SpectrumPhy*, size_t> m_borderPhys; //!< DL PHY to m_borderEnbs index
+    std::vector<double> m_accumulated[2];                  //!< PSD being summed, by parity
+    std::vector<Ghost> m_ghosts;                           //!< eNBs of other shards
+    std::vector<uint32_t> m_peers;                         //!< Shards of the ghosts
+    Ptr<SpectrumChannel> m_channel;                        //!< Downlink channel
+    Ptr<const SpectrumModel> m_model;                      //!< Downlink spectrum model
+};
+
+} // namespace ns3
+
+#endif // SHARD_INTERFERENCE_EXCHANGE_H
@@ -0,0 +1,406 @@
+#ifndef SHM_METRICS_H
+#define SHM_METRICS_H
+
+#include <ns3/core-module.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace ns3
+{
+
+/**
+ * Header of the shared memory segment written by ShmMetricsPublisher.
+ *
+ * The header is followed by numMetrics ShmMetric slots. Everything after the
+ * name table is guarded by a single seqlock: the publisher samples the
+ * values, makes sequence odd, stores the time stamps and the values, then
+ * makes it even again, and a reader retries until it sees the same even
+ * sequence before and after its copy. The publisher never waits for a
+ * reader; a reader gives up after a timeout, as a publisher that died in an
+ * update leaves the sequence odd.
+ */
+struct ShmMetricsHeader
+{
+    char magic[8];                    //!< "LTEMETR1"
+    uint32_t version;                 //!< Format version, currently 1
+    uint32_t numMetrics;              //!< Number of metric slots
+    int32_t pid;                      //!< Publishing process
+    std::atomic<uint32_t> finished;   //!< 1 once the publisher stopped
+    std::atomic<uint64_t> sequence;   //!< Seqlock sequence, odd during an update
+    std::atomic<int64_t> simTime;     //!< Simulation time of the snapshot, in ns
+    std::atomic<int64_t> wallTime;    //!< Steady clock time of the snapshot, in ns
+    std::atomic<uint64_t> eventCount; //!< Events executed at the snapshot
+};
+
+/// One metric slot of the shared memory segment, one cache line each
+struct ShmMetric
+{
+    char name[48];             //!< Metric name, NUL terminated
+    uint32_t kind;             //!< ShmMetricsPublisher::Kind
+    uint32_t reserved;         //!< Padding, always 0
+    std::atomic<double> value; //!< Last published value
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<double>::is_always_lock_free,
+              "The shared memory metrics need lock-free 64 bit atomics");
+
+/**
+ * Publishes counters and gauges of a running simulation into a POSIX shared
+ * memory segment, for lte-metrics-reader or any other local process to watch.
+ *
+ * Every publishing interval (in simulation time) the samplers are called and
+ * their values stored in the segment under a seqlock. This costs the
+ * simulation thread a few plain stores per metric: no system call, no lock
+ * and no I/O, whether a reader is attached or not. The segment is removed when
+ * the publisher is destroyed; a reader that still maps it keeps the last
+ * snapshot.
+ */
+class ShmMetricsPublisher
+{
+  public:
+    /// Kind of metric, which tells the readers how to display it
+    enum Kind : uint32_t
+    {
+        COUNTER = 0, //!< Monotonic total, readers show its rate
+        GAUGE = 1,   //!< Instantaneous value
+    };
+
+    /// Returns the current value of a metric
+    typedef std::function<double()> Sampler;
+
+    /**
+     * \param shmName Name of the shared memory segment, e.g. "/lte-metrics".
+     * \param interval Simulation time between two snapshots.
+     */
+    ShmMetricsPublisher(const std::string& shmName, Time interval = MilliSeconds(100))
+        : m_shmName(shmName),
+          m_interval(interval),
+          m_header(nullptr),
+          m_metrics(nullptr),
+          m_mapLength(0)
+    {
+    }
+
+    ~ShmMetricsPublisher()
+    {
+        if (m_header)
+        {
+            munmap(m_header, m_mapLength);
+            shm_unlink(m_shmName.c_str());
+        }
+    }
+
+    /**
+     * \param name The metric name, at most 47 characters.
+     * \param sampler Returns the running total.
+     */
+    void AddCounter(const std::string& name, Sampler sampler)
+    {
+        Add(name, COUNTER, sampler);
+    }
+
+    /**
+     * \param name The metric name, at most 47 characters.
+     * \param sampler Returns the current value.
+     */
+    void AddGauge(const std::string& name, Sampler sampler)
+    {
+        Add(name, GAUGE, sampler);
+    }
+
+    /**
+     * Create the segment with the registered metrics and start publishing.
+     * \param at Delay of the first snapshot.
+     */
+    void Start(Time at = Seconds(0))
+    {
+        NS_ABORT_MSG_IF(m_header, "The metrics are already published");
+        m_mapLength = sizeof(ShmMetricsHeader) + m_entries.size() * sizeof(ShmMetric);
+        // A segment left over by a crashed run is replaced
+        int fd = shm_open(m_shmName.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        NS_ABORT_MSG_IF(fd < 0, "Cannot create shared memory segment " << m_shmName);
+        NS_ABORT_MSG_IF(ftruncate(fd, static_cast<off_t>(m_mapLength)) != 0,
+                        "Cannot size shared memory segment " << m_shmName);
+        void* addr = mmap(nullptr, m_mapLength, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        NS_ABORT_MSG_IF(addr == MAP_FAILED, "Cannot map shared memory segment " << m_shmName);
+
+        // The segment is zero filled: the atomics only need constructing
+        m_header = new (addr) ShmMetricsHeader;
+        m_header->version = 1;
+        m_header->numMetrics = m_entries.size();
+        m_header->pid = getpid();
+        m_header->finished.store(0, std::memory_order_relaxed);
+        m_header->sequence.store(0, std::memory_order_relaxed);
+        m_metrics = reinterpret_cast<ShmMetric*>(static_cast<char*>(addr) +
+                                                 sizeof(ShmMetricsHeader));
+        for (size_t i = 0; i < m_entries.size(); i++)
+        {
+            ShmMetric* metric = new (&m_metrics[i]) ShmMetric;
+            std::strncpy(metric->name, m_entries[i].name.c_str(), sizeof(metric->name) - 1);
+            metric->kind = m_entries[i].kind;
+            metric->value.store(0, std::memory_order_relaxed);
+        }
+        // Readers check the magic last
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(m_header->magic, "LTEMETR1", sizeof(m_header->magic));
+
+        Simulator::Schedule(at, &ShmMetricsPublisher::Publish, this);
+    }
+
+    /**
+     * Publish a last snapshot and mark the segment as finished. To be called
+     * after Simulator::Run(), while the sampled objects still exist.
+     */
+    void Stop()
+    {
+        if (!m_header)
+        {
+            return;
+        }
+        Write();
+        m_header->finished.store(1, std::memory_order_release);
+    }
+
+  private:
+    /// A registered metric
+    struct Entry
+    {
+        std::string name; //!< Name
+        Kind kind;        //!< Kind
+        Sampler sampler;  //!< Sampler
+    };
+
+    /**
+     * \param name The metric name.
+     * \param kind The metric kind.
+     * \param sampler The sampler.
+     */
+    void Add(const std::string& name, Kind kind, Sampler sampler)
+    {
+        NS_ABORT_MSG_IF(m_header, "Metrics must be added before Start()");
+        NS_ABORT_MSG_IF(name.size() >= sizeof(ShmMetric::name), "Metric name too long: " << name);
+        m_entries.push_back({name, kind, sampler});
+    }
+
+    /// Publish a snapshot and schedule the next one
+    void Publish()
+    {
+        Write();
+        Simulator::Schedule(m_interval, &ShmMetricsPublisher::Publish, this);
+    }
+
+    /// Write a snapshot under the seqlock
+    void Write()
+    {
+        // The samplers run outside of the update, which only stores: the
+        // sequence stays odd for as short as possible
+        m_values.resize(m_entries.size());
+        for (size_t i = 0; i < m_entries.size(); i++)
+        {
+            m_values[i] = m_entries[i].sampler();
+        }
+        int64_t simTime = Simulator::Now().GetNanoSeconds();
+        int64_t wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+        uint64_t eventCount = Simulator::GetEventCount();
+
+        uint64_t seq = m_header->sequence.load(std::memory_order_relaxed);
+        m_header->sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        m_header->simTime.store(simTime, std::memory_order_relaxed);
+        m_header->wallTime.store(wallTime, std::memory_order_relaxed);
+        m_header->eventCount.store(eventCount, std::memory_order_relaxed);
+        for (size_t i = 0; i < m_values.size(); i++)
+        {
+            m_metrics[i].value.store(m_values[i], std::memory_order_relaxed);
+        }
+
+        m_header->sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    std::string m_shmName;        //!< Shared memory segment name
+    Time m_interval;              //!< Publishing interval
+    std::vector<Entry> m_entries; //!< Registered metrics
+    std::vector<double> m_values; //!< Values sampled for the next snapshot
+    ShmMetricsHeader* m_header;   //!< Mapped header, null before Start()
+    ShmMetric* m_metrics;         //!< Mapped metric slots
+    size_t m_mapLength;           //!< Length of the mapping in bytes
+};
+
+/**
+ * Reads the snapshots of a ShmMetricsPublisher from another process.
+ */
+class ShmMetricsReader
+{
+  public:
+    /// A consistent copy of the segment
+    struct Snapshot
+    {
+        int64_t simTime = 0;        //!< Simulation time, in ns
+        int64_t wallTime = 0;       //!< Steady clock time, in ns
+        uint64_t eventCount = 0;    //!< Events executed
+        bool finished = false;      //!< Whether the publisher stopped
+        std::vector<double> values; //!< Metric values, in slot order
+    };
+
+    ShmMetricsReader()
+        : m_header(nullptr),
+          m_metrics(nullptr),
+          m_mapLength(0)
+    {
+    }
+
+    ~ShmMetricsReader()
+    {
+        if (m_header)
+        {
+            munmap(const_cast<ShmMetricsHeader*>(m_header), m_mapLength);
+        }
+    }
+
+    /**
+     * Map a segment read-only.
+     * \param shmName Name of the shared memory segment.
+     * \return False if the segment does not exist or is not initialized yet.
+     */
+    bool Open(const std::string& shmName)
+    {
+        NS_ABORT_MSG_IF(m_header, "A segment is already open");
+        int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        NS_ABORT_MSG_IF(fstat(fd, &st) != 0, "Cannot stat shared memory segment " << shmName);
+        size_t length = static_cast<size_t>(st.st_size);
+        if (length < sizeof(ShmMetricsHeader))
+        {
+            close(fd);
+            return false;
+        }
+        void* addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        NS_ABORT_MSG_IF(addr == MAP_FAILED, "Cannot map shared memory segment " << shmName);
+        const auto* header = static_cast<const ShmMetricsHeader*>(addr);
+        if (std::memcmp(header->magic, "LTEMETR1", sizeof(header->magic)) != 0)
+        {
+            munmap(addr, length);
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        NS_ABORT_MSG_IF(header->version != 1 ||
+                            length < sizeof(ShmMetricsHeader) +
+                                         header->numMetrics * sizeof(ShmMetric),
+                        shmName << " is not a version 1 metrics segment");
+        m_header = header;
+        m_metrics = reinterpret_cast<const ShmMetric*>(static_cast<const char*>(addr) +
+                                                       sizeof(ShmMetricsHeader));
+        m_mapLength = length;
+        return true;
+    }
+
+    /// \return The number of metrics.
+    uint32_t GetN() const
+    {
+        return m_header->numMetrics;
+    }
+
+    /**
+     * \param i Index of a metric.
+     * \return Its name.
+     */
+    std::string GetName(uint32_t i) const
+    {
+        return std::string(m_metrics[i].name, strnlen(m_metrics[i].name, sizeof(ShmMetric::name)));
+    }
+
+    /**
+     * \param i Index of a metric.
+     * \return Whether it is a counter.
+     */
+    bool IsCounter(uint32_t i) const
+    {
+        return m_metrics[i].kind == ShmMetricsPublisher::COUNTER;
+    }
+
+    /// \return The pid of the publisher.
+    int32_t GetPid() const
+    {
+        return m_header->pid;
+    }
+
+    /// \return Whether the publishing process still runs.
+    bool IsPublisherAlive() const
+    {
+        return kill(m_header->pid, 0) == 0 || errno != ESRCH;
+    }
+
+    /**
+     * Copy the last snapshot, retrying while the publisher updates it: a few
+     * times right away, then every millisecond until the timeout.
+     * \param [out] snapshot The copy.
+     * \param timeout Time to give up after, e.g. if the publisher died in an
+     * update.
+     * \return False if no snapshot was published yet, or none could be copied
+     * before the timeout.
+     */
+    bool Read(Snapshot& snapshot,
+              std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)) const
+    {
+        snapshot.values.resize(m_header->numMetrics);
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (uint32_t attempt = 0;; attempt++)
+        {
+            if (attempt >= 100)
+            {
+                if (std::chrono::steady_clock::now() > deadline)
+                {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            uint64_t before = m_header->sequence.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                continue;
+            }
+            snapshot.simTime = m_header->simTime.load(std::memory_order_relaxed);
+            snapshot.wallTime = m_header->wallTime.load(std::memory_order_relaxed);
+            snapshot.eventCount = m_header->eventCount.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < m_header->numMetrics; i++)
+            {
+                snapshot.values[i] = m_metrics[i].value.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_header->sequence.load(std::memory_order_relaxed) == before)
+            {
+                snapshot.finished = m_header->finished.load(std::memory_order_acquire) != 0;
+                return before != 0;
+            }
+        }
+    }
+
+  private:
+    const ShmMetricsHeader* m_header; //!< Mapped header, null before Open()
+    const ShmMetric* m_metrics;       //!< Mapped metric slots
+    size_t m_mapLength;               //!< Length of the mapping in bytes
+};
+
+} // namespace ns3
+
+#endif // SHM_METRICS_H
@@ -0,0 +1,258 @@
+#ifndef TOPK_A2A4_RSRQ_HANDOVER_ALGORITHM_H
+#define TOPK_A2A4_RSRQ_HANDOVER_ALGORITHM_H
+
+#include <ns3/core-module.h>
+#include <ns3/lte-module.h>
+
+#include <algorithm>
+#include <array>
+
+namespace ns3
+{
+
+/**
+ * A2-A4-RSRQ handover algorithm keeping only the best K neighbours of each UE.
+ *
+ * The rule is that of A2A4RsrqHandoverAlgorithm: on an A2 report (serving
+ * RSRQ below ServingCellThreshold) the UE is handed over to its best known
+ * neighbour if that one is at least NeighbourCellOffset better. The
+ * measurement handling is what changes with the number of cells:
+ *
+ *  - the A4 reporting configuration asks the UEs for their MaxNeighbourCells
+ *    strongest neighbours only, instead of the default 8;
+ *  - the eNB stores them in a fixed array of K (cell id, RSRQ) entries per UE
+ *    in a flat table indexed by RNTI, instead of a map of maps of
+ *    heap-allocated measures that keeps every neighbour ever reported.
+ *
+ * An A4 report updates the entries of the cells it lists, and a new cell
+ * takes the place of the weakest entry when it is better. Processing a report
+ * and evaluating a handover are thus O(K), independent of the number of cells
+ * the UE went by. Only the eNB side is bounded: the UE RRC still measures,
+ * stores and sorts every cell it detects, and only truncates its report to
+ * the K best.
+ *
+ * The decisions are not always those of A2A4RsrqHandoverAlgorithm, even fed
+ * the same reports. That one keeps the last RSRQ of every neighbour ever
+ * reported, so it may pick a cell no longer reported whose stale RSRQ is the
+ * best; here that entry may have been evicted by a better cell since. Ties
+ * between neighbours may also go to another cell. In a scenario the UEs
+ * report K neighbours instead of 8 as well. Select it with
+ *
+ *   lteHelper->SetHandoverAlgorithmType("ns3::TopKA2A4RsrqHandoverAlgorithm");
+ */
+class TopKA2A4RsrqHandoverAlgorithm : public LteHandoverAlgorithm
+{
+  public:
+    /// Largest number of neighbours kept per UE
+    static constexpr uint8_t MAX_NEIGHBOURS = LteRrcSap::MaxReportCells;
+
+    TopKA2A4RsrqHandoverAlgorithm()
+        : m_handoverManagementSapUser(nullptr)
+    {
+        m_handoverManagementSapProvider =
+            new MemberLteHandoverManagementSapProvider<TopKA2A4RsrqHandoverAlgorithm>(this);
+    }
+
+    ~TopKA2A4RsrqHandoverAlgorithm() override
+    {
+    }
+
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::TopKA2A4RsrqHandoverAlgorithm")
+                .SetParent<LteHandoverAlgorithm>()
+                .AddConstructor<TopKA2A4RsrqHandoverAlgorithm>()
+                .AddAttribute("ServingCellThreshold",
+                              "RSRQ range below which the UE looks for a better cell (0-34)",
+                              UintegerValue(30),
+                              MakeUintegerAccessor(
+                                  &TopKA2A4RsrqHandoverAlgorithm::m_servingCellThreshold),
+                              MakeUintegerChecker<uint8_t>(0, 34))
+                .AddAttribute("NeighbourCellOffset",
+                              "RSRQ range the best neighbour must exceed the serving cell by",
+                              UintegerValue(1),
+                              MakeUintegerAccessor(
+                                  &TopKA2A4RsrqHandoverAlgorithm::m_neighbourCellOffset),
+                              MakeUintegerChecker<uint8_t>())
+                .AddAttribute("MaxNeighbourCells",
+                              "Neighbours reported by each UE and kept per UE",
+                              UintegerValue(4),
+                              MakeUintegerAccessor(
+                                  &TopKA2A4RsrqHandoverAlgorithm::m_maxNeighbourCells),
+                              MakeUintegerChecker<uint8_t>(1, MAX_NEIGHBOURS));
+        return tid;
+    }
+
+    void SetLteHandoverManagementSapUser(LteHandoverManagementSapUser* s) override
+    {
+        m_handoverManagementSapUser = s;
+    }
+
+    LteHandoverManagementSapProvider* GetLteHandoverManagementSapProvider() override
+    {
+        return m_handoverManagementSapProvider;
+    }
+
+    friend class MemberLteHandoverManagementSapProvider<TopKA2A4RsrqHandoverAlgorithm>;
+
+  protected:
+    void DoInitialize() override
+    {
+        LteRrcSap::ReportConfigEutra reportConfigA2;
+        reportConfigA2.eventId = LteRrcSap::ReportConfigEutra::EVENT_A2;
+        reportConfigA2.threshold1.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRQ;
+        reportConfigA2.threshold1.range = m_servingCellThreshold;
+        reportConfigA2.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRQ;
+        reportConfigA2.reportInterval = LteRrcSap::ReportConfigEutra::MS240;
+        m_a2MeasIds = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(reportConfigA2);
+
+        LteRrcSap::ReportConfigEutra reportConfigA4;
+        reportConfigA4.eventId = LteRrcSap::ReportConfigEutra::EVENT_A4;
+        reportConfigA4.threshold1.choice = LteRrcSap::ThresholdEutra::THRESHOLD_RSRQ;
+        reportConfigA4.threshold1.range = 0; // every neighbour qualifies, as in A2A4Rsrq
+        reportConfigA4.triggerQuantity = LteRrcSap::ReportConfigEutra::RSRQ;
+        reportConfigA4.reportInterval = LteRrcSap::ReportConfigEutra::MS480;
+        reportConfigA4.maxReportCells = m_maxNeighbourCells;
+        m_a4MeasIds = m_handoverManagementSapUser->AddUeMeasReportConfigForHandover(reportConfigA4);
+
+        LteHandoverAlgorithm::DoInitialize();
+    }
+
+    void DoDispose() override
+    {
+        delete m_handoverManagementSapProvider;
+        m_neighbours.clear();
+        LteHandoverAlgorithm::DoDispose();
+    }
+
+    void DoReportUeMeas(uint16_t rnti, LteRrcSap::MeasResults measResults) override
+    {
+        if (std::find(m_a2MeasIds.begin(), m_a2MeasIds.end(), measResults.measId) !=
+            m_a2MeasIds.end())
+        {
+            EvaluateHandover(rnti, measResults.measResultPCell.rsrqResult);
+        }
+        else if (std::find(m_a4MeasIds.begin(), m_a4MeasIds.end(), measResults.measId) !=
+                 m_a4MeasIds.end())
+        {
+            if (measResults.haveMeasResultNeighCells)
+            {
+                UeNeighbours& ue = GetUe(rnti);
+                for (const auto& cell : measResults.measResultListEutra)
+                {
+                    NS_ASSERT_MSG(cell.haveRsrqResult, "RSRQ measurement is missing");
+                    Update(ue, cell.physCellId, cell.rsrqResult);
+                }
+            }
+        }
+    }
+
+  private:
+    /// RSRQ of one neighbour
+    struct Neighbour
+    {
+        uint16_t cellId; //!< Cell id, 0 for an unused entry
+        uint8_t rsrq;    //!< Last reported RSRQ range
+    };
+
+    /// Best neighbours of one UE, unordered
+    struct UeNeighbours
+    {
+        std::array<Neighbour, MAX_NEIGHBOURS> cells{}; //!< Entries
+        uint8_t n = 0;                                 //!< Used entries
+    };
+
+    /**
+     * \param rnti An RNTI.
+     * \return The neighbours of the UE, empty for a new one.
+     */
+    UeNeighbours& GetUe(uint16_t rnti)
+    {
+        if (rnti >= m_neighbours.size())
+        {
+            m_neighbours.resize(rnti + 1);
+        }
+        return m_neighbours[rnti];
+    }
+
+    /**
+     * Record the RSRQ of a neighbour, if it is among the best K.
+     *
+     * \param ue The neighbours of the UE.
+     * \param cellId The neighbour cell.
+     * \param rsrq Its RSRQ range.
+     */
+    void Update(UeNeighbours& ue, uint16_t cellId, uint8_t rsrq)
+    {
+        uint8_t weakest = 0;
+        for (uint8_t i = 0; i < ue.n; i++)
+        {
+            if (ue.cells[i].cellId == cellId)
+            {
+                ue.cells[i].rsrq = rsrq;
+                return;
+            }
+            if (ue.cells[i].rsrq < ue.cells[weakest].rsrq)
+            {
+                weakest = i;
+            }
+        }
+        if (ue.n < m_maxNeighbourCells)
+        {
+            ue.cells[ue.n++] = {cellId, rsrq};
+        }
+        else if (rsrq > ue.cells[weakest].rsrq)
+        {
+            ue.cells[weakest] = {cellId, rsrq};
+        }
+    }
+
+    /**
+     * Hand the UE over to its best neighbour if it is good enough.
+     *
+     * \param rnti The RNTI of the UE.
+     * \param servingCellRsrq The RSRQ range of the serving cell.
+     */
+    void EvaluateHandover(uint16_t rnti, uint8_t servingCellRsrq)
+    {
+        if (rnti >= m_neighbours.size())
+        {
+            return; // no neighbour reported yet
+        }
+        const UeNeighbours& ue = m_neighbours[rnti];
+        uint16_t bestCellId = 0;
+        uint8_t bestRsrq = 0;
+        for (uint8_t i = 0; i < ue.n; i++)
+        {
+            if (ue.cells[i].rsrq > bestRsrq)
+            {
+                bestCellId = ue.cells[i].cellId;
+                bestRsrq = ue.cells[i].rsrq;
+            }
+        }
+        if (bestCellId > 0 && bestRsrq - servingCellRsrq >= m_neighbourCellOffset)
+        {
+            m_handoverManagementSapUser->TriggerHandover(rnti, bestCellId);
+        }
+    }
+
+    uint8_t m_servingCellThreshold;                                    //!< A2 threshold
+    uint8_t m_neighbourCellOffset;                                     //!< Handover margin
+    uint8_t m_maxNeighbourCells;                                       //!< K
+    std::vector<uint8_t> m_a2MeasIds;                                  //!< A2 measurement ids
+    std::vector<uint8_t> m_a4MeasIds;                                  //!< A4 measurement ids
+    std::vector<UeNeighbours> m_neighbours;                            //!< Per RNTI
+    LteHandoverManagementSapUser* m_handoverManagementSapUser;         //!< SAP user
+    LteHandoverManagementSapProvider* m_handoverManagementSapProvider; //!< SAP provider
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TopKA2A4RsrqHandoverAlgorithm);
+
+} // namespace ns3
+
+#endif // TOPK_A2A4_RSRQ_HANDOVER_ALGORITHM_H
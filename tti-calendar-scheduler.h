@@ -0,0 +1,244 @@
+#ifndef TTI_CALENDAR_SCHEDULER_H
+#define TTI_CALENDAR_SCHEDULER_H
+
+#include <ns3/core-module.h>
+#include <ns3/scheduler.h>
+
+#include <deque>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * Calendar queue event scheduler with the bucket width fixed to the LTE TTI.
+ *
+ * LTE scenarios schedule most of their events on 1 ms subframe boundaries, so
+ * with one bucket per TTI an insertion usually lands at the back of a bucket
+ * holding events with the same timestamp, and a removal pops the front of the
+ * current bucket: both are O(1) instead of the O(log n) of the map and heap
+ * schedulers. Only the number of buckets is adapted to the queue size; the
+ * width stays at the TTI so that bucket boundaries keep matching subframes.
+ *
+ * Events are dispatched in (timestamp, uid) order, exactly like the other
+ * ns-3 schedulers. Select it with
+ *
+ *   GlobalValue::Bind("SchedulerType", StringValue("ns3::TtiCalendarScheduler"));
+ */
+class TtiCalendarScheduler : public Scheduler
+{
+  public:
+    TtiCalendarScheduler()
+        : m_width(0),
+          m_mask(0),
+          m_qSize(0),
+          m_lastBucket(0),
+          m_bucketTop(0),
+          m_lastPrio(0)
+    {
+    }
+
+    ~TtiCalendarScheduler() override
+    {
+    }
+
+    /**
+     * Register this type.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("ns3::TtiCalendarScheduler")
+                .SetParent<Scheduler>()
+                .AddConstructor<TtiCalendarScheduler>()
+                .AddAttribute("BucketWidth",
+                              "Width of a calendar bucket, normally one TTI",
+                              TimeValue(MilliSeconds(1)),
+                              MakeTimeAccessor(&TtiCalendarScheduler::m_bucketWidth),
+                              MakeTimeChecker(TimeStep(1)))
+                .AddAttribute("MinBuckets",
+                              "Number of buckets the calendar never shrinks below, "
+                              "must be a power of two",
+                              UintegerValue(256),
+                              MakeUintegerAccessor(&TtiCalendarScheduler::m_minBuckets),
+                              MakeUintegerChecker<uint32_t>(2));
+        return tid;
+    }
+
+    void Insert(const Event& ev) override
+    {
+        if (m_buckets.empty())
+        {
+            Init();
+        }
+        DoInsert(m_buckets, ev);
+        m_qSize++;
+        if (m_qSize > 2 * m_buckets.size())
+        {
+            Resize(m_buckets.size() * 2);
+        }
+    }
+
+    bool IsEmpty() const override
+    {
+        return m_qSize == 0;
+    }
+
+    Event PeekNext() const override
+    {
+        NS_ASSERT(!IsEmpty());
+        uint64_t bucketTop;
+        uint32_t bucket = FindNext(bucketTop);
+        return m_buckets[bucket].front();
+    }
+
+    Event RemoveNext() override
+    {
+        NS_ASSERT(!IsEmpty());
+        uint64_t bucketTop;
+        uint32_t bucket = FindNext(bucketTop);
+        Event ev = m_buckets[bucket].front();
+        m_buckets[bucket].pop_front();
+        m_lastBucket = bucket;
+        m_bucketTop = bucketTop;
+        m_lastPrio = ev.key.m_ts;
+        m_qSize--;
+        if (m_qSize < m_buckets.size() / 4 && m_buckets.size() > m_minBuckets)
+        {
+            Resize(m_buckets.size() / 2);
+        }
+        return ev;
+    }
+
+    void Remove(const Event& ev) override
+    {
+        NS_ASSERT(!IsEmpty());
+        std::deque<Event>& bucket = m_buckets[Hash(ev.key.m_ts)];
+        for (auto i = bucket.begin(); i != bucket.end(); ++i)
+        {
+            if (i->key.m_uid == ev.key.m_uid)
+            {
+                NS_ASSERT(ev.impl == i->impl);
+                bucket.erase(i);
+                m_qSize--;
+                return;
+            }
+        }
+        NS_ASSERT_MSG(false, "Event " << ev.key.m_uid << " not found in the calendar");
+    }
+
+  private:
+    /// Convert the bucket width to ticks and allocate the initial calendar
+    void Init()
+    {
+        m_width = static_cast<uint64_t>(m_bucketWidth.GetTimeStep());
+        NS_ABORT_MSG_IF(m_minBuckets & (m_minBuckets - 1), "MinBuckets must be a power of two");
+        m_buckets.resize(m_minBuckets);
+        m_mask = m_minBuckets - 1;
+        m_lastBucket = 0;
+        m_bucketTop = m_width;
+        m_lastPrio = 0;
+    }
+
+    /**
+     * \param ts An event timestamp.
+     * \return The bucket holding timestamp ts.
+     */
+    uint32_t Hash(uint64_t ts) const
+    {
+        return static_cast<uint32_t>((ts / m_width) & m_mask);
+    }
+
+    /**
+     * Insert an event in its bucket, keeping the bucket sorted. Most events
+     * go to the back, so the scan starts there.
+     *
+     * \param buckets The calendar to insert into.
+     * \param ev The event.
+     */
+    void DoInsert(std::vector<std::deque<Event>>& buckets, const Event& ev) const
+    {
+        std::deque<Event>& bucket = buckets[(ev.key.m_ts / m_width) & (buckets.size() - 1)];
+        auto i = bucket.end();
+        while (i != bucket.begin() && ev.key < (i - 1)->key)
+        {
+            --i;
+        }
+        bucket.insert(i, ev);
+    }
+
+    /**
+     * Find the bucket holding the earliest event.
+     *
+     * \param [out] bucketTop The end of the TTI covered by that bucket.
+     * \return The bucket index.
+     */
+    uint32_t FindNext(uint64_t& bucketTop) const
+    {
+        uint32_t i = m_lastBucket;
+        bucketTop = m_bucketTop;
+        do
+        {
+            const std::deque<Event>& bucket = m_buckets[i];
+            if (!bucket.empty() && bucket.front().key.m_ts < bucketTop)
+            {
+                return i;
+            }
+            i = (i + 1) & m_mask;
+            bucketTop += m_width;
+        } while (i != m_lastBucket);
+
+        // Nothing in the coming year: fall back to a direct search
+        uint32_t best = 0;
+        bool found = false;
+        for (uint32_t j = 0; j < m_buckets.size(); j++)
+        {
+            if (!m_buckets[j].empty() &&
+                (!found || m_buckets[j].front().key < m_buckets[best].front().key))
+            {
+                best = j;
+                found = true;
+            }
+        }
+        NS_ASSERT(found);
+        bucketTop = (m_buckets[best].front().key.m_ts / m_width + 1) * m_width;
+        return best;
+    }
+
+    /**
+     * Change the number of buckets, keeping the bucket width.
+     * \param newSize The new number of buckets, a power of two.
+     */
+    void Resize(size_t newSize)
+    {
+        std::vector<std::deque<Event>> buckets(newSize);
+        for (const auto& bucket : m_buckets)
+        {
+            for (const auto& ev : bucket)
+            {
+                DoInsert(buckets, ev);
+            }
+        }
+        m_buckets.swap(buckets);
+        m_mask = static_cast<uint32_t>(newSize - 1);
+        m_lastBucket = Hash(m_lastPrio);
+        m_bucketTop = (m_lastPrio / m_width + 1) * m_width;
+    }
+
+    Time m_bucketWidth;      //!< Bucket width attribute
+    uint32_t m_minBuckets;   //!< Minimum number of buckets
+    uint64_t m_width;        //!< Bucket width in ticks
+    uint32_t m_mask;         //!< Number of buckets minus one
+    uint32_t m_qSize;        //!< Number of queued events
+    uint32_t m_lastBucket;   //!< Bucket of the last dequeued event
+    uint64_t m_bucketTop;    //!< End of the TTI covered by m_lastBucket
+    uint64_t m_lastPrio;     //!< Timestamp of the last dequeued event
+    std::vector<std::deque<Event>> m_buckets; //!< The calendar
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TtiCalendarScheduler);
+
+} // namespace ns3
+
+#endif // TTI_CALENDAR_SCHEDULER_H